@@ -0,0 +1,54 @@
+/*
+ * File:   aggregate.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Aggregate : counts over the retained logs, in place, in a single pass.
+ * The logs, or their entries, are grouped by a key token taken from their text :
+ * the field-th token, or the field-th one after a prefix (e.g. "PD" or "ec=").
+ * A token is a run of letters, digits and '_', as for Zone; entries added by
+ * add_log_entry() start with their number, which is their token 0. Every group
+ * keeps its count, the tsc range of its logs, and the range of an optional
+ * numeric token following the key. Store logs may be split into segments
+ * aggregated by several threads, whose groups are then merged.
+ *
+ *     Aggregate_query q;
+ *     q.entries = true;
+ *     q.prefix = "EC";
+ *     q.last = 100;
+ *     Aggregate_group g[64];
+ *     size_t n = Aggregate::group(q, g, 64);  // entries per EC in the last 100 logs
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "types.hpp"
+
+struct Aggregate_query {
+    static const size_t NONE = ~0ul;
+
+    bool entries = false;           // group the entries, rather than the logs by their title
+    const char *prefix = nullptr;   // fields are counted from its first occurrence; texts without it are skipped
+    size_t field = 0;               // token of the key
+    size_t value = NONE;            // token, counted after the key, holding the number of the value range
+    size_t last = NONE;             // only the last logs, in the Log_walk order : cold, queue then store logs
+    unsigned threads = 1;           // aggregating the store logs
+};
+
+struct Aggregate_group {
+    static const size_t KEY = 24;
+
+    uint64 hash;                    // of the whole key
+    size_t count;
+    uint64 tsc_min, tsc_max;        // of the logs, or of the entries
+    long long value_min, value_max; // meaningless if the query has no value, or count_values is 0
+    size_t count_values;            // texts with a value
+    char key[KEY];                  // cut to KEY characters
+    size_t key_length;
+};
+
+class Aggregate {
+public:
+    static size_t group(Aggregate_query const&, Aggregate_group*, size_t, size_t&);
+
+    static size_t group(Aggregate_query const&, Aggregate_group*, size_t);
+};
@@ -0,0 +1,80 @@
+/*
+ * File:   cold.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Cold : the cold tier of the queue logs (Log). Once a queue log is older
+ * than a given age, the Reclaimer thread packs it into a single immutable record
+ * of a byte ring, and destroys its Log, Log_entry, String and Block objects. A
+ * cold log is laid out as :
+ *
+ *   Cold_log
+ *   title bytes
+ *   Cold_entry, entry bytes        for every entry, back to back, unaligned
+ *
+ * where the entries, once set_compression() is called, are compressed with Lz
+ * when it makes them shorter; they are then decompressed, into a buffer of the
+ * reading thread, to be read. When eviction is due, the oldest queue logs are
+ * packed as well, instead of being destroyed; the oldest cold logs are dropped
+ * when the ring is full. Logs bigger than a quarter of the ring are never
+ * packed. The tier is disabled until set_age() is called.
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "types.hpp"
+#include "compiler.hpp"
+#include "config.hpp"
+#include "record_ring.hpp"
+#include "sink.hpp"
+
+class Log;
+
+struct Cold_log {
+    uint64 tsc;
+    uint32 title_length;
+    uint32 entries;
+    uint32 bytes;           // of the entries, Cold_entry included
+    uint32 compressed;      // of the entries as stored, if compressed; 0 otherwise
+
+    const char* title() const { return reinterpret_cast<const char*>(this + 1); }
+};
+
+struct Cold_entry {
+    uint64 tsc_delta;       // from the owning log's tsc
+    uint32 length;
+    uint32 reserved;
+};
+
+class Cold {
+    friend class Log_walk;
+private:
+    static Record_ring<LOG_COLD_BYTES, LOG_COLD_BYTES / 32> ring;
+    static uint64 age;      // in tsc; 0 while the tier is disabled
+    static bool compressing;
+    static size_t unpacked; // logs too big to be packed, destroyed by evict()
+
+    static bool pack(Log*);
+
+    static void spill(Record const&);
+
+    static char* buffer();
+
+    static const char* unpack(const char*, size_t, size_t);
+
+public:
+    static void set_age(uint64);
+
+    static void set_compression(bool on) { compressing = on; }
+
+    static uint64 get_age() { return age; }
+
+    static bool enabled() { return age; }
+
+    static size_t get_number() { return ring.size(); }
+
+    static void migrate();
+
+    static void evict(size_t);
+
+    static void dump(char const*, Sink& = Sink::out());
+};
@@ -43,9 +43,36 @@
 
 #define MAX_INSTRUCTION 0x100000
 #define STR_MAX_LENGTH  120
-#define LOG_MAX         10000
-#define LOG_PERCENT_TO_BE_LEFT 10
-#define LOG_ENTRY_MAX   20*LOG_MAX
+#define LOG_MAX         16384   // power of 2, as Ring capacities have to be
+#define LOG_ENTRY_MAX   (16*LOG_MAX)
+#define LOG_ENTRY_BYTES (1ul << 20) // Logstore entry record ring, power of 2
+#define LOG_TITLE_BYTES (1ul << 20) // Logstore title record ring, power of 2
+#define LOG_ENTRY_RING  Record_ring // Logstore entries : Record_ring, or Slot_ring of 128 bytes slots
+#define LOG_COLD_BYTES  (1ul << 20) // Cold ring of packed aging queue logs, power of 2
+#define LOG_BACKEND     Log     // Logger backend : Log (heap queue) or Logstore (record rings)
+#define RECLAIM_PERIOD_US 1000
+#define DUMP_CHUNK      256 // logs rendered at once by a thread of a parallel dump
+#define JOURNAL_ORDER   24  // 2^JOURNAL_ORDER bytes of journal ring
+#define LIVE_ORDER      22  // 2^LIVE_ORDER bytes of shared memory live ring
+#define SPILL_ORDER     22  // 2^SPILL_ORDER bytes of spill staging ring
+#define SPILL_FILE_BYTES (64ul << 20) // size cap of a spill file
+#define SPILL_FILES     4   // spill files rotated through
+#define SPILL_PERIOD_US 10000
+#define ZONE_LOGS       16  // Logstore logs summarized by a zone
+#define ZONE_BLOOM_BITS 4096
+#ifndef LOG_LEVEL_MIN
+#define LOG_LEVEL_MIN   0   // TRACE() calls below this Log_level are compiled out, may be set with -D
+#endif
+#define LOG_CATEGORIES  32
+
+#define HEAP_HIGH_WATERMARK         90  // percentage of the heap in use
+#define HEAP_LOW_WATERMARK          75
+#define LOG_HIGH_WATERMARK          (LOG_MAX*9/10)
+#define LOG_LOW_WATERMARK           (LOG_MAX*3/4)
+#define LOG_ENTRY_HIGH_WATERMARK    (LOG_ENTRY_MAX*9/10)
+#define LOG_ENTRY_LOW_WATERMARK     (LOG_ENTRY_MAX*3/4)
+#define LOG_EVICTION_SLICE          8   // minimum number of logs evicted at once
+#define RECLAIM_SLICE               64  // maximum number of logs evicted by the Reclaimer per lock hold
 
 #define PAGE_BITS       12
 #define PAGE_SIZE       (1 << PAGE_BITS)
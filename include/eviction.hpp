@@ -0,0 +1,58 @@
+/*
+ * File:   eviction.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Eviction : high/low watermarks on the heap bytes in use, the log count and
+ * the log entry count. As soon as one of them crosses its high watermark, the
+ * oldest logs are evicted until every one of them is back under its low
+ * watermark. Retained history thus stays near capacity and each eviction only
+ * costs the (high - low) slice, instead of the former 90% emergency purge.
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "types.hpp"
+#include "compiler.hpp"
+#include "config.hpp"
+#include "reclaimer.hpp"
+
+class Eviction {
+private:
+    struct Watermark {
+        size_t heap;    // percentage of the heap bytes in use
+        size_t logs;    // logs, in each of Log and Logstore
+        size_t entries; // log entries, in each of Log and Logstore
+    };
+    static Watermark high, low, hard;
+    static bool above(Watermark const &);
+    static size_t evict_oldest(size_t);
+
+public:
+    /**
+     * Inline check of the logging path. When the Reclaimer thread is running,
+     * it is in charge of the high watermark; producers only evict if it falls
+     * behind and a hard limit is reached : the log or entry capacity of the
+     * Logstore, or the heap usage halfway between its high watermark and
+     * exhaustion
+     */
+    ALWAYS_INLINE
+    static inline void check() {
+        if(EXPECT_FALSE(above(Reclaimer::active ? hard : high)))
+            evict_to_low();
+    }
+
+    static bool above_high() { return above(high); }
+
+    static bool evict_slice(size_t = ~0ul);
+
+    static void evict_to_low();
+
+    static bool evict_bytes(size_t, bool = true);
+
+    static void set_heap_watermarks(size_t, size_t);
+
+    static void set_log_watermarks(size_t, size_t);
+
+    static void set_entry_watermarks(size_t, size_t);
+    static void fit(size_t, size_t);
+};
@@ -0,0 +1,44 @@
+/*
+ * File:   journal.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Journal : optional crash-persistent copy of every committed log, title
+ * append and entry, in a MAP_SHARED file mapping (see journal_format.hpp). The
+ * mapping outlives the process : after a SIGKILL, a segfault or an OOM kill,
+ * the file still holds every committed record, and can be reopened to go on
+ * logging or read post-mortem with tools/journal_reader. Writing a record is a
+ * copy into the mapping, without any system call.
+ *
+ * The Block heap itself cannot be placed in the file : it is described by
+ * pointer-linked Block objects, and defragment() moves strings around, so the
+ * journal keeps its own offset-addressed records instead.
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "journal_format.hpp"
+#include "compiler.hpp"
+#include "config.hpp"
+
+class Journal {
+private:
+    static Journal_header *header;
+    static char *ring;
+    static size_t mapped;
+    static void write(uint32, uint64, const char*, size_t);
+
+public:
+    ALWAYS_INLINE
+    static inline void record(uint32 type, uint64 tsc, const char* s, size_t length) {
+        if(EXPECT_FALSE(header != nullptr))
+            write(type, tsc, s, length);
+    }
+
+    static void append(Journal_header*, char*, uint32, uint64, const char*, size_t, bool);
+
+    static bool open(char const*, unsigned = JOURNAL_ORDER);
+
+    static void sync();
+
+    static void close();
+};
@@ -0,0 +1,71 @@
+/*
+ * File:   journal_format.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The journal file format, shared by Journal (the writer) and the post-mortem
+ * reader tool. The file is a Journal_header followed by a ring of size bytes
+ * (a power of 2). The ring holds back-to-back records, each a Journal_record
+ * followed by its payload, padded to 16 bytes. Records never wrap : the end of
+ * the ring is filled with a JOURNAL_PAD record instead.
+ *
+ * head and tail are monotonic byte counts; their position in the ring is
+ * (count & (size - 1)). Records in [tail, head) are committed. head is the
+ * commit marker : it is only advanced, with a release store, once the record
+ * is completely written, so a record torn by a crash is never read.
+ *
+ * The spill files written by Spill share the record format : a Spill_header
+ * followed by back-to-back records up to the end of the file, which never
+ * wrap. JOURNAL_PAD records may show up in them as well.
+ *
+ * The live ring written by Live to a POSIX shared memory object has the
+ * journal layout, with LIVE_MAGIC. Its producer never waits for the readers,
+ * which only map it read-only : before overwriting the oldest records, it
+ * advances tail and issues a release fence, and then writes. A reader keeps its
+ * own position; it reads the record there in place, once below head (acquire),
+ * and then checks, after an acquire fence, that tail did not pass it meanwhile.
+ * Otherwise what it read may be torn : it is dropped, and the reader resumes
+ * from tail. magic is stored last, with a release store, once the ring is set.
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "types.hpp"
+
+#define JOURNAL_MAGIC       0x4c4e524a47544c53ull  // "SLTGJRNL"
+#define JOURNAL_VERSION     1
+#define SPILL_MAGIC         0x4c49505347544c53ull  // "SLTGSPIL"
+#define LIVE_MAGIC          0x4556494c47544c53ull  // "SLTGLIVE"
+
+enum {
+    JOURNAL_PAD     = 0,    // filler up to the end of the ring
+    JOURNAL_LOG     = 1,    // a new log, payload is its title
+    JOURNAL_ENTRY   = 2,    // a new entry of the last log
+    JOURNAL_APPEND  = 3,    // text appended to the last log's title
+};
+
+struct Journal_header {
+    uint64 magic;
+    uint32 version;
+    uint32 header_size;
+    uint64 size;            // of the ring
+    uint64 head;            // commit marker
+    uint64 tail;
+    uint64 reserved[3];
+};
+
+struct Spill_header {
+    uint64 magic;
+    uint32 version;         // JOURNAL_VERSION
+    uint32 header_size;
+    uint64 sequence;        // of the file, since Spill::open
+};
+
+struct Journal_record {
+    uint32 length;          // of the payload
+    uint32 type;
+    uint64 tsc;
+};
+
+static inline uint64 journal_record_size(uint32 length) {
+    return (sizeof(Journal_record) + length + 15) & ~15ull;
+}
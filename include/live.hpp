@@ -0,0 +1,40 @@
+/*
+ * File:   live.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Live : optional copy of every committed log, title append and entry into
+ * a ring placed in a POSIX shared memory object, so that another process on the
+ * host, e.g. a log collector, tails the logs while they are being written (see
+ * Live_reader and tools/live_reader). The ring has the journal layout, with
+ * LIVE_MAGIC (see journal_format.hpp); writing a record is a copy into the
+ * mapping, without any system call. The producer never waits for the readers :
+ * the oldest records are overwritten, and readers which lag behind lose them.
+ *
+ *     Live::open("/mylogs");      // readers : live_reader /mylogs
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "journal_format.hpp"
+#include "compiler.hpp"
+#include "config.hpp"
+
+class Live {
+private:
+    static Journal_header *header;
+    static char *ring;
+    static size_t mapped;
+    static char name[256];
+    static void write(uint32, uint64, const char*, size_t);
+
+public:
+    ALWAYS_INLINE
+    static inline void record(uint32 type, uint64 tsc, const char* s, size_t length) {
+        if(EXPECT_FALSE(header != nullptr))
+            write(type, tsc, s, length);
+    }
+
+    static bool open(char const*, unsigned = LIVE_ORDER);
+
+    static void close();
+};
@@ -0,0 +1,143 @@
+/*
+ * File:   live_reader.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Live_reader : tails, from another process, the shared memory ring written
+ * by Live, following the protocol described in journal_format.hpp. The ring is
+ * mapped read-only; records are views pointing into it, and reading them takes
+ * no system call. As the producer never waits, a record may be overwritten
+ * while it is being consumed : valid() tells, once it has been.
+ *
+ *     Live_reader r;
+ *     Live_record x;
+ *     if(r.open("/mylogs"))
+ *         while(true)
+ *             if(r.next(x)) {
+ *                 consume(x.type, x.text, x.length);
+ *                 if(!r.valid())
+ *                     drop();     // x was overwritten meanwhile
+ *             } else
+ *                 wait();         // caught up with the producer
+ *
+ * Header only, so that readers only need the include directory.
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "journal_format.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+struct Live_record {
+    uint32 type;            // JOURNAL_LOG, JOURNAL_ENTRY or JOURNAL_APPEND
+    uint64 tsc;
+    const char *text;       // in the ring, not null terminated
+    uint32 length;
+};
+
+class Live_reader {
+private:
+    const Journal_header *header = nullptr;
+    const char *ring = nullptr;
+    size_t mapped = 0;
+    uint64 mask = 0;
+    uint64 position = 0;    // of the next record
+    uint64 current = 0;     // position of the last record read
+    uint64 skipped = 0;     // bytes of records overwritten before they could be read
+
+public:
+    ~Live_reader() { close(); }
+
+    /**
+     * Maps the ring of the shared memory object n
+     * @param n : "/name", as given to Live::open
+     * @param from_tail : from the oldest record kept (true) or from the next one
+     * @return false if there is no such ring, or it is not set up yet
+     */
+    bool open(char const *n, bool from_tail = true) {
+        close();
+        int fd = shm_open(n, O_RDONLY, 0);
+        struct stat st;
+        if(fd < 0)
+            return false;
+        void *m = fstat(fd, &st) || static_cast<size_t>(st.st_size) < sizeof(Journal_header) ?
+                MAP_FAILED : mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if(m == MAP_FAILED)
+            return false;
+        const Journal_header *h = reinterpret_cast<const Journal_header*>(m);
+        mapped = static_cast<size_t>(st.st_size);
+        if(__atomic_load_n(&h->magic, __ATOMIC_ACQUIRE) != LIVE_MAGIC || h->version != JOURNAL_VERSION ||
+                h->header_size != sizeof(Journal_header) || !h->size || (h->size & (h->size - 1)) ||
+                sizeof(Journal_header) + h->size > mapped) {
+            munmap(m, mapped);
+            return false;
+        }
+        header = h;
+        ring = reinterpret_cast<const char*>(h + 1);
+        mask = h->size - 1;
+        position = __atomic_load_n(from_tail ? &h->tail : &h->head, __ATOMIC_ACQUIRE);
+        skipped = 0;
+        return true;
+    }
+
+    void close() {
+        if(header)
+            munmap(const_cast<Journal_header*>(header), mapped);
+        header = nullptr;
+    }
+
+    /**
+     * Reads the next record, skipping those overwritten meanwhile
+     * @param r : a view of it, to be checked with valid() once consumed
+     * @return false if the reader caught up with the producer
+     */
+    bool next(Live_record &r) {
+        while(true) {
+            uint64 head = __atomic_load_n(&header->head, __ATOMIC_ACQUIRE),
+                    tail = __atomic_load_n(&header->tail, __ATOMIC_ACQUIRE);
+            if(position < tail) {
+                skipped += tail - position;
+                position = tail;
+            }
+            if(position >= head)
+                return false;
+            const Journal_record *x = reinterpret_cast<const Journal_record*>(ring + (position & mask));
+            r.length = __atomic_load_n(&x->length, __ATOMIC_RELAXED);
+            r.type = __atomic_load_n(&x->type, __ATOMIC_RELAXED);
+            r.tsc = __atomic_load_n(&x->tsc, __ATOMIC_RELAXED);
+            r.text = reinterpret_cast<const char*>(x + 1);
+            current = position;
+            if(!valid())
+                continue;       // overwritten meanwhile : resume from tail
+            uint64 size = journal_record_size(r.length);
+            if((position & mask) + size > mask + 1 || position + size > head) {
+                skipped += head - position;     // not a record the producer wrote
+                position = head;
+                return false;
+            }
+            position += size;
+            if(r.type != JOURNAL_PAD)
+                return true;
+        }
+    }
+
+    /**
+     * Was the last record returned by next() left intact since ? What was
+     * consumed of it before valid() returns true is consistent.
+     * @return
+     */
+    bool valid() const {
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        return __atomic_load_n(&header->tail, __ATOMIC_RELAXED) <= current;
+    }
+
+    uint64 lost() const { return skipped; }
+
+    /**
+     * @return bytes committed by the producer, which are yet to be read
+     */
+    uint64 pending() const { return __atomic_load_n(&header->head, __ATOMIC_ACQUIRE) - position; }
+};
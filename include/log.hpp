@@ -16,6 +16,9 @@
 #include "compiler.hpp"
 #include "queue.hpp"
 #include "string.hpp"
+#include "timer.hpp"
+#include "sink.hpp"
+#include "log_front.hpp"
 #include <cassert>
 #include <cstdio>
 
@@ -24,12 +27,15 @@ class Log;
 class Log_entry {
     friend class Queue<Log_entry>;
     friend class Log;
-    friend class Logentrystore;
+    friend class Eviction;
+    friend class Log_walk;
+    friend class Cold;
 
     static size_t log_entry_number;
 
     String *log_entry = nullptr;
     Log_entry *prev = nullptr, *next = nullptr;
+    uint64 tsc_delta = 0; // timestamp, relative to the owning log's tsc
 //        size_t numero = 0;
 
 //        ALWAYS_INLINE
@@ -52,32 +58,59 @@ class Log_entry {
     Log_entry &operator=(Log_entry const &);
 
 //  Log_entry(char* l, Log* log) {
-    Log_entry(char* l);
-
-    void print(){
-        printf("%s\n", log_entry->get_string());
+    Log_entry(const char* l);
+
+    /**
+     * Prints this entry, preceded by its time
+     * @param sink
+     * @param base : the owning log's tsc
+     */
+    void print(Sink &sink, uint64 base){
+        sink.format("tsc %llu ", base + tsc_delta);
+        sink.put(log_entry->get_string(), log_entry->get_length());
+        sink.put("\n", 1);
     }
 
     static size_t get_total_log_size() { return log_entry_number; }
     
 };
 
-class Log {
+class Log : public Log_front<Log> {
     friend class Queue<Log>;
-    friend class Logentrystore;
-    friend class Logstore;
+    friend class Log_front<Log>;
+    friend class Eviction;
+    friend class Log_walk;
+    friend class Cold;
     static Queue<Log> logs;
-    static char *entry_buffer, *entry_buffer_cursor, *log_buffer, *log_buffer_cursor;
     static size_t log_number;
+    static size_t dropped; // entries dropped as their log's index could not grow
     
-    size_t start_in_store = 0;
     size_t log_size = 0;
+    size_t bytes = 0; // heap bytes used by its info and entries
     size_t numero = 0;
+    uint64 tsc = 0; // timestamp of the log creation; base of its entries' tsc_delta
     String *info = nullptr;
     Queue<Log_entry> log_entries = {};
+    Log_entry **entry_index = nullptr; // entries by number, for O(1) random access
+    size_t index_capacity = 0;
+    bool packed = false; // copied into the Cold tier, not to be spilled when freed
     Log* prev = nullptr;
     Log* next = nullptr;
     
+    void print(Sink&, bool);
+
+    void spill();
+
+    static void put_log(const char*, size_t);
+
+    static void put_entry(const char*, size_t);
+
+    static void put_info(const char*, size_t);
+
+    static void report(Sink&);
+
+    static size_t last_size() { return logs.tail()->log_size; }
+    
 public:
     static bool log_on;
 
@@ -97,6 +130,7 @@ public:
             delete li;
         } 
         delete info;
+        free(entry_index);
         assert(log_number);
         log_number--;
     } 
@@ -110,19 +144,12 @@ public:
         
     static size_t get_number(){ return log_number; }
     
-    static void add_log(const char*);
-    
     static void free_logs(size_t=0, bool=false);
     
-    static void dump(char const*, bool = true, size_t = 5);
-            
-    static void add_log_entry(const char*);
-    
-    static void append_log_info(const char*);
+    static void dump(char const*, bool = true, size_t = 5, Sink& = Sink::out(), unsigned = 1);
     
-    static void add_entry_in_buffer(const char*);
-    
-    static void add_log_in_buffer(const char*);
-    
-    static void commit_buffer();
+    static void dump_window(char const*, uint64, uint64, Sink& = Sink::out());
 };
+
+template <typename B>
+inline bool Log_front<B>::on() { return Log::log_on; }
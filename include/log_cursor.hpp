@@ -0,0 +1,149 @@
+/*
+ * File:   log_cursor.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Log_cursor : lock-free, zero-copy reading of a Log_store (Logstore by
+ * default) while producers go on logging, e.g. from a monitoring thread. Records
+ * and entries are views pointing into the store's rings; every store slot
+ * carries a Seqcount, so that the reader can tell whether what it has just
+ * consumed was overwritten or evicted in the meantime :
+ *
+ *     Log_cursor c;
+ *     Log_record r;
+ *     while(c.next(r)) {
+ *         consume(r.title, r.title_length);
+ *         c.entries(r, [](Entry_view const &e) { consume(e.text, e.length); });
+ *         if(!c.valid())
+ *             c.retry();  // r was written meanwhile; drop what was consumed of it
+ *     }
+ *
+ * Queue logs (Log) are heap objects, freed on eviction, and are not covered :
+ * read them with Log_walk, under a Reclaimer::Guard.
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "log.hpp"
+#include "log_store.hpp"
+#include "log_walk.hpp"
+
+struct Log_record {
+    size_t index;           // absolute, stable, store position of the log
+    size_t numero;          // its number when it was read
+    size_t size;            // number of entries
+    uint64 tsc;
+    const char *title;
+    size_t title_length;
+    size_t first_entry;     // number of its first entry record (low 32 bits)
+};
+
+template <typename S = Logstore::Store>
+class Log_cursor {
+private:
+    S &store;
+    size_t index;           // of the next record
+    size_t current = ~0ul;  // index of the last record returned
+    size_t skipped = 0;     // records evicted before they could be read
+    uint32 seq = 0;
+
+public:
+    /**
+     * @param s : the store to be read
+     * @param from : absolute index of the first record; the oldest log by default
+     */
+    explicit Log_cursor(S &s = Logstore::store, size_t from = 0) : store(s), index(from) {}
+
+    /**
+     * A cursor which only yields the logs committed from now on
+     * @param s
+     */
+    static Log_cursor tail(S &s = Logstore::store) { return Log_cursor(s, s.cursor()); }
+
+    /**
+     * Reads the next log, skipping those evicted meanwhile
+     * @param r : filled with a consistent view of the log
+     * @return false if the cursor caught up with the producers
+     */
+    bool next(Log_record &r) {
+        while(true) {
+            size_t start = store.titles.start();
+            if(index < start) {
+                skipped += start - index;
+                index = start;
+            }
+            if(index >= store.titles.cursor())
+                return false;
+            size_t at = store.slot(index);
+            Seqcount &sc = store.seqs[at];
+            uint32 s = sc.read_begin();
+            start = store.titles.start();
+            if(index < start)
+                continue;
+            Record *title = store.title_records.at(ACCESS_ONCE(store.titles[index]));
+            r.index = index;
+            r.numero = index - start;
+            r.size = ACCESS_ONCE(store.sizes[at]);
+            r.tsc = ACCESS_ONCE(store.tscs[at]);
+            r.first_entry = ACCESS_ONCE(store.firsts[at]);
+            r.title = title->text();
+            r.title_length = ACCESS_ONCE(title->length);
+            if(sc.read_retry(s))
+                continue;       // written meanwhile : read it again
+            current = index++;
+            seq = s;
+            return true;
+        }
+    }
+
+    /**
+     * Was the last record returned by next() left intact since ? Views of it
+     * which have been consumed before valid() returns true are consistent.
+     * @return
+     */
+    bool valid() const {
+        if(!~current)
+            return false;
+        return !store.seqs[store.slot(current)].read_retry(seq) && current >= store.titles.start();
+    }
+
+    /**
+     * Reads the k-th entry of r, in O(1)
+     * @param r : the last record returned by next()
+     * @param k
+     * @param e
+     * @return false if r was overwritten meanwhile
+     */
+    bool entry(Log_record const &r, size_t k, Entry_view &e) const {
+        if(r.index != current || k >= r.size)
+            return false;
+        return store.entry_records.walk(r.first_entry + k, 1, [&](auto const &x) {
+            e = {x.text(), ACCESS_ONCE(x.length), ACCESS_ONCE(x.tsc_delta)};
+        }) && valid();
+    }
+
+    /**
+     * Calls f(Entry_view const &) on the entries of r, in order, as long as r
+     * is intact
+     * @param r : the last record returned by next()
+     * @param f
+     * @return false if r was overwritten meanwhile
+     */
+    template <typename F>
+    bool entries(Log_record const &r, F f) const {
+        if(r.index != current)
+            return false;
+        return store.entry_records.walk(r.first_entry, r.size, [&](auto const &x) {
+            f(Entry_view{x.text(), ACCESS_ONCE(x.length), ACCESS_ONCE(x.tsc_delta)});
+        }) && valid();
+    }
+
+    /**
+     * Makes next() read the last record again, e.g. once valid() failed
+     */
+    void retry() {
+        if(~current)
+            index = current;
+    }
+
+    size_t lost() const { return skipped; }
+};
@@ -0,0 +1,152 @@
+/*
+ * File:   log_front.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Log_front : the logging API, shared by the storage backends, Log (queue
+ * of heap logs) and Logstore (record rings), which derive from it :
+ *
+ *     class Log : public Log_front<Log> { ... };
+ *
+ * The front end filters, formats, buffers and commits; a backend B only provides
+ * its storage primitives, called without any virtual dispatch :
+ *
+ *     static void put_log(const char *s, size_t n);    // a new log, titled s
+ *     static void put_entry(const char *s, size_t n);  // an entry to the last log
+ *     static void put_info(const char *s, size_t n);   // s appended to the last log's title
+ *     static size_t last_size();                       // entries of the last log
+ *     static void dump_window(char const*, uint64, uint64, Sink&);
+ *
+ * Logger (include/logger.hpp) is the backend chosen by LOG_BACKEND at compile time.
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "config.hpp"
+#include "string.hpp"
+#include "timer.hpp"
+#include "sink.hpp"
+#include "reclaimer.hpp"
+#include "eviction.hpp"
+
+class Log;
+
+template <typename B>
+class Log_front {
+private:
+    static char entry_buffer[PAGE_SIZE], log_buffer[PAGE_SIZE];
+    static char *entry_buffer_cursor, *log_buffer_cursor;
+
+    static bool on(); // Log::log_on
+
+public:
+    /**
+     * Adds a new log
+     * @param s
+     */
+    static void add_log(const char* s){
+        Reclaimer::Guard guard;
+        if(!on() || !strlen(s))
+            return;
+        Eviction::check();
+        B::put_log(s, strlen(s));
+    }
+
+    /**
+     * Adds an entry to the last log, numbered after its previous entries
+     * @param log
+     */
+    static void add_log_entry(const char* log){
+        Reclaimer::Guard guard;
+        if(!on() || !strlen(log))
+            return;
+        Eviction::check();
+        char buff[STR_MAX_LENGTH];
+        String::print(buff, sizeof(buff), "%lu %s", B::last_size(), log);
+        B::put_entry(buff, strlen(buff));
+    }
+
+    /**
+     * Appends s to the title of the last log, after a space
+     * @param s
+     */
+    static void append_log_info(const char* s){
+        Reclaimer::Guard guard;
+        if(!on() || !strlen(s))
+            return;
+        B::put_info(s, strlen(s));
+    }
+
+    /**
+     * store new log to the logs'buffer
+     * @param s
+     */
+    static void add_log_in_buffer(const char* s){
+        Reclaimer::Guard guard;
+        if(!on() || !strlen(s))
+            return;
+        size_t size = strlen(s);
+        copy_string(log_buffer_cursor, s);
+        *(log_buffer_cursor + size) = ' '; // replace the final '\0' by ' '
+        log_buffer_cursor += size + 1;
+    }
+
+    /**
+     * store new log entry to the entries'buffer
+     * @param s
+     */
+    static void add_entry_in_buffer(const char* s){
+        Reclaimer::Guard guard;
+        if(!on() || !strlen(s))
+            return;
+        size_t size = strlen(s)+1; // +1 for the final \n
+        copy_string_nl(entry_buffer_cursor, s, size);
+        entry_buffer_cursor += size;
+    }
+
+    /**
+     * Commit log buffer and entries buffer : the log, and its entries as a
+     * single one
+     */
+    static void commit_buffer(){
+        Reclaimer::Guard guard;
+        if(!on())
+            return;
+        if(!strlen(log_buffer))
+            return;
+        *log_buffer_cursor = '\0';
+        add_log(log_buffer);
+        memset(log_buffer, 0, log_buffer_cursor - log_buffer + 1);
+        log_buffer_cursor = log_buffer;
+
+        if(!strlen(entry_buffer))
+            return;
+        *entry_buffer_cursor = '\0';
+        Eviction::check();
+        B::put_entry(entry_buffer, entry_buffer_cursor - entry_buffer);
+        memset(entry_buffer, 0, entry_buffer_cursor - entry_buffer + 1);
+        entry_buffer_cursor = entry_buffer;
+    }
+
+    /**
+     * Prints the logs created during the last us microseconds
+     * @param funct_name : Where we come from
+     * @param us
+     * @param sink
+     */
+    static void dump_last(char const *funct_name, uint64 us, Sink &sink = Sink::out()){
+        uint64 now = Timer::now(), d = Timer::us_to_tsc(us);
+        B::dump_window(funct_name, now > d ? now - d : 0, now, sink);
+    }
+};
+
+template <typename B>
+char Log_front<B>::entry_buffer[PAGE_SIZE];
+
+template <typename B>
+char Log_front<B>::log_buffer[PAGE_SIZE];
+
+template <typename B>
+char *Log_front<B>::entry_buffer_cursor = Log_front<B>::entry_buffer;
+
+template <typename B>
+char *Log_front<B>::log_buffer_cursor = Log_front<B>::log_buffer;
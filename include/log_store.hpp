@@ -1,60 +1,369 @@
-/* 
+/*
  * File:   log_store.hpp
  * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
- * The Log store : provide almost ready-to-be-used logs, so it does not create 
- * new log by resorting to new keyword. It can hold up to LOG_MAX logs and 
- * LOG_ENTRY_MAX log entries
- * 
+ * The Log store : provide almost ready-to-be-used logs, so it does not create
+ * new log by resorting to new keyword. A Log_store<LOGS, ENTRY_BYTES, TITLE_BYTES>
+ * holds up to LOGS logs, whose titles and entries are length-prefixed records
+ * written back to back in two byte rings of its own, outside of the Block heap :
+ * adding one is a single copy, and freeing the oldest ones advances the rings'
+ * heads. Entries may rather be kept in fixed cache-line slots, see Slot_ring.
+ * When a ring is full, the oldest logs are evicted, LOG_EVICTION_SLICE at
+ * a time. Every instance owns its memory, so that subsystems can log into stores
+ * of their own, sized for them, without evicting each other's logs. The template
+ * parameters are the storage reserved; resize() chooses, at run time, how much
+ * of it is used, and the rest is never touched.
+ * Logstore is the default instance, behind the Log_front interface.
+ *
  * Created on 17 octobre 2019, 19:50
  */
 #pragma once
 
 #include "config.hpp"
 #include "log.hpp"
+#include "ring.hpp"
+#include "record_ring.hpp"
+#include "slot_ring.hpp"
+#include "seqlock.hpp"
+#include "reclaimer.hpp"
+#include "trace.hpp"
+#include "spill.hpp"
+#include "render.hpp"
 
-class Logentrystore {
+template <size_t LOGS, size_t ENTRY_BYTES, size_t TITLE_BYTES, template <size_t> class ENTRIES = Record_ring>
+class Log_store {
     friend class Logstore;
+    friend class Log_walk;
+    template <typename> friend class Log_cursor;
 private:
-    static Log_entry logentries[LOG_ENTRY_MAX];
-// Next log index in the logentryies table, start index to save the table current start index*/ 
-    static size_t cursor, start ;
-    static void add_log_entry(const char*);
-    
+    static_assert(LOGS > 1, "a Log_store keeps its newest log while adding another one");
+
+    /*
+     * Per-log metadata, in parallel columns indexed like titles (absolute index
+     * masked into the ring), so that a scan only touches the columns it needs.
+     * The numero of a log is its index minus start()
+     */
+    Ring<uint32, LOGS> titles;          // title record number, low 32 bits; also start and cursor
+    uint64 tscs[LOGS];                  // creation; base of the entries' tsc_delta
+    uint32 sizes[LOGS];                 // number of entries
+    uint32 firsts[LOGS];                // first entry record number, low 32 bits; entry k is firsts + k
+    Seqcount seqs[LOGS];                // changes whenever the slot is written or freed
+    Record_ring<TITLE_BYTES, LOGS> title_records;
+    ENTRIES<ENTRY_BYTES> entry_records;    // a Record_ring, or a Slot_ring of fixed cache-line entries
+    size_t rejected = 0;                // entries longer than entry_records.max_length()
+
+    size_t title_max() const { return title_records.capacity()/4 - sizeof(Record); } // longer titles are cut
+
+    size_t slot(size_t index) const { return titles.slot(index); }
+
+    /**
+     * Frees the oldest logs, LOG_EVICTION_SLICE at a time. The newest log is
+     * always kept
+     * @return false if only the newest log is left
+     */
+    bool evict() {
+        size_t n = titles.size();
+        if(n <= 1)
+            return false;
+        free_logs(n - min(n - 1, static_cast<size_t>(LOG_EVICTION_SLICE)), false);
+        return true;
+    }
+
+    /**
+     * Appends a record to the entries of the last log, evicting older logs if
+     * the entry ring is full. Entries too long for the ring are rejected, and
+     * counted for the dumps to report them
+     * @param s
+     * @param n : length of s
+     * @return the number of the record, ~0ul if it was dropped
+     */
+    size_t add_record(const char *s, size_t n) {
+        size_t i = titles.cursor() - 1, at = slot(i), number;
+        assert(!titles.empty());
+        if(EXPECT_FALSE(n > entry_records.max_length())) {
+            rejected++;
+            return ~0ul;
+        }
+        seqs[at].write_begin();
+        while(!~(number = entry_records.add(s, n, Timer::delta(tscs[at]))) && evict());
+        if(~number && !sizes[at]++)
+            firsts[at] = static_cast<uint32>(number);
+        seqs[at].write_end();
+        return number;
+    }
+
+    /**
+     * Hands the title and entries of the log of absolute index i over to the
+     * Spill, before it is freed
+     * @param i
+     */
+    void spill(size_t i) {
+        size_t at = slot(i);
+        Record *title = title_records.at(titles[i]);
+        Spill::record(JOURNAL_LOG, tscs[at], title->text(), title->length);
+        entry_records.walk(firsts[at], sizes[at], [&](auto const &e) {
+            Spill::record(JOURNAL_ENTRY, tscs[at] + e.tsc_delta, e.text(), e.length);
+        });
+        Spill::commit();
+    }
+
+    /**
+     * Writes the number of entries rejected for their length, if any
+     * @param sink
+     */
+    void report(Sink &sink) const {
+        if(rejected)
+            sink.format("Rejected %lu entries longer than %lu\n", rejected, entry_records.max_length());
+    }
+
 public:
-    Logentrystore();
-    Logentrystore(const Logentrystore& orig);
-    ~Logentrystore();
-    static size_t get_logentry_total_number() {
-        return cursor - start;
-    }
-    static void free_logentries(size_t, size_t);
-    static void dump(bool, size_t, size_t);
+    size_t get_number() const { return titles.size(); }
+
+    size_t get_entry_number() const { return entry_records.size(); }
+
+    size_t start() const { return titles.start(); }
+
+    size_t cursor() const { return titles.cursor(); }
+
+    size_t last_size() const { return sizes[slot(titles.cursor() - 1)]; }
+
+    size_t capacity() const { return titles.capacity(); }
+
+    size_t entry_capacity() const { return entry_records.max_size(); }
+
+    /**
+     * Chooses how much of the reserved storage is used, before the first log;
+     * sizes are rounded down to a power of 2 and clamped to what is reserved
+     * @param logs : at least 2
+     * @param entry_bytes
+     * @param title_bytes : at least 64
+     * @return false if logs have been added already
+     */
+    bool resize(size_t logs, size_t entry_bytes, size_t title_bytes) {
+        Reclaimer::Guard guard;
+        if(titles.cursor())
+            return false;
+        auto fit = [](size_t n, size_t lo, size_t hi) {
+            n = min(max(n, lo), hi);
+            return 1ul << (63 - __builtin_clzl(n));
+        };
+        logs = fit(logs, 2, LOGS);
+        entry_bytes = fit(entry_bytes, 128, ENTRY_BYTES);
+        titles.resize(logs);
+        title_records.resize(fit(title_bytes, 64, TITLE_BYTES), logs);
+        entry_records.resize(entry_bytes, entry_bytes / sizeof(Record));
+        return true;
+    }
+
+    /**
+     * Adds a new log, whose title is cut to title_max() characters
+     * @param log
+     * @param n : length of log
+     * @return its absolute index
+     */
+    size_t add_log(const char *log, size_t n) {
+        Reclaimer::Guard guard;
+        n = min(n, title_max());
+        size_t number = ~0ul;
+        while((titles.full() || !~(number = title_records.add(log, n, 0))) && evict());
+        assert(~number); // the newest log and a new title, of at most title_max() each, always fit
+        size_t i = titles.cursor(), at = slot(i);
+        seqs[at].write_begin();
+        titles.next() = static_cast<uint32>(number);
+        tscs[at] = Timer::now();
+        sizes[at] = 0;
+        seqs[at].write_end();
+        titles.push(); // publish the slot to readers
+        return i;
+    }
+
+    /**
+     * Adds an entry to the last log, numbered after its previous entries
+     * @param log
+     * @return the number of the entry record, ~0ul if it was dropped
+     */
+    size_t add_log_entry(const char *log) {
+        Reclaimer::Guard guard;
+        assert(!titles.empty());
+        char buff[STR_MAX_LENGTH];
+        String::print(buff, sizeof(buff), "%lu %s", static_cast<size_t>(sizes[slot(titles.cursor() - 1)]), log);
+        return add_record(buff, strlen(buff));
+    }
+
+    /**
+     * Adds n characters of s, which may span several lines, as a single entry
+     * of the last log; with a Slot_ring, it is rejected if longer than a slot
+     * @param s
+     * @param n
+     * @return the number of the entry record, ~0ul if it was dropped
+     */
+    size_t add_log_entries(const char *s, size_t n) {
+        Reclaimer::Guard guard;
+        return add_record(s, n);
+    }
+
+    /**
+     * Appends s to the title of the last log, after a space
+     * @param s
+     * @param n : length of s
+     * @return false if the title would be longer than title_max(), or not fit
+     */
+    bool append_log_info(const char *s, size_t n) {
+        Reclaimer::Guard guard;
+        size_t i = titles.cursor() - 1, at = slot(i);
+        bool done;
+        assert(!titles.empty());
+        if(title_records.at(titles[i])->length + 1 + n > title_max())
+            return false;
+        seqs[at].write_begin();
+        while(!(done = title_records.extend(' ', s, n)) && evict());
+        seqs[at].write_end();
+        return done;
+    }
+
+    /**
+     * Frees (100 - left) percent logs (if in_percent == true) or left logs (if
+     * in_percent == false), starting by the oldest log
+     * @param left
+     * @param in_percent
+     */
+    void free_logs(size_t left = 0, bool in_percent = false) {
+        Reclaimer::Guard guard;
+        if(titles.empty())
+            return;
+        if(in_percent){
+            assert(left && left < 100);
+            left = left * titles.size()/100;
+        }
+        if(!left)
+            left = 1;
+        size_t entries = 0, // entries of the freed logs, the oldest ones of the entry ring
+                freed = titles.size() > left ? titles.size() - left : 0;
+        titles.range(titles.start(), titles.start() + freed, [&](uint32, size_t i) {
+            size_t at = slot(i);
+            if(Spill::on())
+                spill(i);
+            seqs[at].write_begin();
+            entries += sizes[at];
+            sizes[at] = 0;
+            firsts[at] = 0;
+            seqs[at].write_end();
+        });
+        entry_records.free(entries);
+        title_records.free(freed);
+        titles.pop(freed);
+    }
+
+    /**
+     * Binary search of the first log, between start and cursor, whose tsc is not
+     * lower than tsc. Logs are stored in creation order, so tsc grows with the index
+     * @param tsc
+     * @return the log's absolute index (cursor if there is none)
+     */
+    size_t lower_bound(uint64 tsc) const {
+        size_t lo = titles.start(), hi = titles.cursor();
+        while(lo < hi) {
+            size_t mid = lo + (hi - lo)/2;
+            if(tscs[slot(mid)] < tsc)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+
+    /**
+     * Gathers the log at the absolute index and its entries into sink, which
+     * has to be flushed by the caller
+     * @param index
+     * @param sink
+     */
+    void print(size_t index, Sink &sink) {
+        size_t at = slot(index);
+        Record *title = title_records.at(titles[index]);
+        sink.format("LOG %lu size %lu tsc %llu ", index - titles.start(),
+                static_cast<size_t>(sizes[at]), tscs[at]);
+        sink.put(title->text(), title->length);
+        sink.put("\n", 1);
+        entry_records.walk(firsts[at], sizes[at], [&](auto const &r) {
+            sink.format("tsc %llu ", tscs[at] + r.tsc_delta);
+            sink.put(r.text(), r.length);
+            sink.put("\n", 1);
+        });
+    }
+
+    /**
+     * @param from_tail : From the first log (from_tail == false) or from the last
+     * @param log_depth : the number of log to be printed; all logs if this is 0
+     * @param sink
+     * @param threads : rendering the logs, in chunks, see Render
+     */
+    void dump(bool from_tail, size_t log_depth, Sink &sink, unsigned threads = 1) {
+        Reclaimer::Guard guard;
+        if(titles.empty())
+            return;
+        Trace_site::report(sink);
+        report(sink);
+        size_t start = titles.start(), cursor = titles.cursor(),
+                depth = log_depth && log_depth < cursor - start ? log_depth : cursor - start;
+        Render::run(depth, threads, sink, [&](size_t k, Sink &s) {
+            print(from_tail ? cursor - 1 - k : start + k, s);
+        });
+    }
+
+    /**
+     * Prints the logs created between tsc_from and tsc_to (both included). The
+     * window bounds are found by binary search, so only the selected logs are read
+     * @param funct_name : Where we come from
+     * @param tsc_from
+     * @param tsc_to
+     * @param sink
+     */
+    void dump_window(char const *funct_name, uint64 tsc_from, uint64 tsc_to, Sink &sink) {
+        Reclaimer::Guard guard;
+        if(titles.empty() || tsc_from > tsc_to)
+            return;
+        size_t first = lower_bound(tsc_from), last = ~tsc_to ? lower_bound(tsc_to + 1) : titles.cursor();
+        sink.format("%s Log %lu log entries %lu window %llu -> %llu\n", funct_name, titles.size(),
+                entry_records.size(), tsc_from, tsc_to);
+        Trace_site::report(sink);
+        report(sink);
+        for(size_t i = first; i < last; i++)
+            print(i, sink);
+        sink.flush();
+    }
 };
 
-class Logstore {
+class Logstore : public Log_front<Logstore> {
+    friend class Log_front<Logstore>;
 private:
-    static Log logs[LOG_MAX];
-    static size_t cursor, start, log_number;
-    
+    static bool sized;
+
+    static void put_log(const char*, size_t);
+
+    static void put_entry(const char*, size_t);
+
+    static void put_info(const char*, size_t);
+
+    static size_t last_size() { return store.last_size(); }
+
 public:
+    typedef Log_store<LOG_MAX, LOG_ENTRY_BYTES, LOG_TITLE_BYTES, LOG_ENTRY_RING> Store;
+
+    static Store store;
+
     Logstore();
     Logstore(const Logstore& orig);
     ~Logstore();
-    
-    static void add_log(const char*);
-        
-    static void free_logs(size_t=0, bool=false);
-        
-    static void dump(char const*, bool = true, size_t = 5);
-            
-    static void add_log_entry(const char*);
-    
-    static void append_log_info(const char*);
-    
-    static void add_entry_in_buffer(const char*);
-    
-    static void add_log_in_buffer(const char*);
-    
-    static void commit_buffer();
-    
+
+    static bool init(size_t = 0, size_t = 0, size_t = 0);
+
+    static size_t get_number() { return store.get_number(); }
+
+    static size_t get_entry_number() { return store.get_entry_number(); }
+
+    static void free_logs(size_t left = 0, bool in_percent = false) { store.free_logs(left, in_percent); }
+
+    static void dump(char const*, bool = true, size_t = 5, Sink& = Sink::out(), unsigned = 1);
+
+    static void dump_window(char const*, uint64, uint64, Sink& = Sink::out());
 };
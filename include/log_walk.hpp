@@ -0,0 +1,201 @@
+/*
+ * File:   log_walk.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Log_walk : read-only traversal of the cold logs (Cold), of the queue logs
+ * (Log) and then of the store logs (Logstore, or any Log_store), from the oldest
+ * to the newest, and of their entries. Logs and entries are handed over as views
+ * pointing into the Block heap or the rings, which are only valid until the next
+ * logging call; the entries of a compressed cold log are decompressed into a
+ * buffer of the calling thread, and only valid until the next walk of a cold
+ * log's entries.
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "log.hpp"
+#include "log_store.hpp"
+#include "cold.hpp"
+
+struct Log_view {
+    Log *log;               // queue log, handle for Log_walk::entries()
+    size_t first_entry;     // store log, number of its first entry record
+    size_t numero;
+    size_t size;            // number of entries
+    uint64 tsc;
+    const char *title;
+    size_t title_length;
+    bool store;             // Log_store log
+    const char *packed;     // cold log, its packed entries, as stored
+    size_t compressed;      // cold log, stored length of its entries if compressed
+    size_t packed_bytes;    // cold log, length of its entries
+};
+
+struct Entry_view {
+    const char *text;
+    size_t length;
+    uint64 tsc_delta;       // from the owning log's tsc
+};
+
+class Log_walk {
+private:
+    static Log_view view(Log *l) {
+        return {l, 0, l->numero, l->log_size, l->tsc, l->info->get_string(), l->info->get_length(), false, 
+                nullptr, 0, 0};
+    }
+
+    template <typename S>
+    static Log_view view(S &s, size_t index) {
+        size_t at = s.slot(index);
+        Record *title = s.title_records.at(s.titles[index]);
+        return {nullptr, s.firsts[at], index - s.titles.start(), s.sizes[at], s.tscs[at], 
+                title->text(), title->length, true, nullptr, 0, 0};
+    }
+
+    static Log_view view(Record const &r, size_t numero) {
+        Cold_log c;
+        memcpy(&c, r.text(), sizeof(c));
+        const char *title = r.text() + sizeof(c);
+        return {nullptr, 0, numero, c.entries, c.tsc, title, c.title_length, false, 
+                title + c.title_length, c.compressed, c.bytes};
+    }
+
+    static Entry_view view(Log_entry *e) {
+        return {e->log_entry->get_string(), e->log_entry->get_length(), e->tsc_delta};
+    }
+
+public:
+    /**
+     * Calls f(Log_view const &) on every log
+     * @param f
+     */
+    template <typename F>
+    static void logs(F f) {
+        cold_logs(f);
+        queue_logs(f);
+        store_logs(store_start(), store_cursor(), f);
+    }
+
+    /**
+     * Calls f(Log_view const &) on every cold log
+     * @param f
+     */
+    template <typename F>
+    static void cold_logs(F f) {
+        size_t first = Cold::ring.first_number(), numero = 0;
+        Cold::ring.walk(first, Cold::ring.size(), [&](Record const &r) { f(view(r, numero++)); });
+    }
+
+    /**
+     * Calls f(Log_view const &) on every queue log
+     * @param f
+     */
+    template <typename F>
+    static void queue_logs(F f) {
+        Log *l = Log::logs.head();
+        while(l) {
+            f(view(l));
+            l = (l->next == Log::logs.head()) ? nullptr : l->next;
+        }
+    }
+
+    /**
+     * Calls f(Log_view const &) on the logs of the store s of absolute indexes
+     * [from, to), which must lie within [s.start(), s.cursor())
+     * @param s
+     * @param from
+     * @param to
+     * @param f
+     */
+    template <typename S, typename F>
+    static void store_logs(S &s, size_t from, size_t to, F f) {
+        for(size_t i = from; i < to; i++)
+            f(view(s, i));
+    }
+
+    template <typename F>
+    static void store_logs(size_t from, size_t to, F f) { store_logs(Logstore::store, from, to, f); }
+
+    static size_t store_start() { return Logstore::store.start(); }
+
+    static size_t store_cursor() { return Logstore::store.cursor(); }
+
+    /**
+     * Calls f(Entry_view const &) on the entries [from, to) of the log v of the
+     * store s, in order. The first one is found in O(1), from its number
+     * @param s
+     * @param v
+     * @param from
+     * @param to
+     * @param f
+     */
+    template <typename S, typename F>
+    static void entries(S &s, Log_view const &v, size_t from, size_t to, F f) {
+        to = min(to, v.size);
+        if(from >= to)
+            return;
+        s.entry_records.walk(v.first_entry + from, to - from, [&](auto const &r) {
+            f(Entry_view{r.text(), r.length, r.tsc_delta});
+        });
+    }
+
+    template <typename S, typename F>
+    static void entries(S &s, Log_view const &v, F f) { entries(s, v, 0, v.size, f); }
+
+    /**
+     * Calls f(Entry_view const &) on the entries [from, to) of the log v, in
+     * order; store logs are those of Logstore. The first one is found in O(1),
+     * from the log's entry index, but for cold logs, which are read from their
+     * first entry on, once decompressed (see Cold) if they were compressed
+     * @param v
+     * @param from
+     * @param to
+     * @param f
+     */
+    template <typename F>
+    static void entries(Log_view const &v, size_t from, size_t to, F f) {
+        if(v.store) {
+            entries(Logstore::store, v, from, to, f);
+            return;
+        }
+        to = min(to, v.size);
+        if(v.packed) {
+            const char *p = Cold::unpack(v.packed, v.compressed, v.packed_bytes);
+            Cold_entry e;
+            for(size_t k = 0; p && k < to; k++) {
+                memcpy(&e, p, sizeof(e));
+                p += sizeof(e);
+                if(k >= from)
+                    f(Entry_view{p, e.length, e.tsc_delta});
+                p += e.length;
+            }
+            return;
+        }
+        for(size_t k = from; k < to; k++)
+            f(view(v.log->entry_index[k]));
+    }
+
+    /**
+     * Calls f(Entry_view const &) on every entry of the log v, in order
+     * @param v
+     * @param f
+     */
+    template <typename F>
+    static void entries(Log_view const &v, F f) { entries(v, 0, v.size, f); }
+
+    /**
+     * Reads the k-th entry of the log v, in O(1) but for cold logs
+     * @param v
+     * @param k
+     * @param e
+     * @return false if v has no k-th entry
+     */
+    static bool entry(Log_view const &v, size_t k, Entry_view &e) {
+        bool found = false;
+        entries(v, k, k + 1, [&](Entry_view const &x) {
+            e = x;
+            found = true;
+        });
+        return found;
+    }
+};
@@ -0,0 +1,15 @@
+/*
+ * File:   logger.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Logger : the storage backend chosen at compile time by LOG_BACKEND, Log or
+ * Logstore, behind the same Log_front API, e.g. Logger::add_log(title)
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "config.hpp"
+#include "log.hpp"
+#include "log_store.hpp"
+
+typedef LOG_BACKEND Logger;
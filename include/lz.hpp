@@ -0,0 +1,35 @@
+/*
+ * File:   lz.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Lz : a small LZ77 byte codec, for the cold logs (see Cold), whose titles
+ * and entries repeat a lot. A compressed block is a sequence of :
+ *
+ *   token          literals count (high 4 bits), match length - 4 (low 4 bits)
+ *   literals count - 15, as 255 bytes and a last byte below 255, if it is 15
+ *   literals
+ *   offset         2 bytes, little endian, back from the current position
+ *   match length - 19, likewise, if it is 15
+ *
+ * the last sequence stopping after its literals. Matches are found through a
+ * hash table of the last position of every 4 bytes prefix, which takes no
+ * allocation : compressing is a single pass, decompressing a copy loop.
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "types.hpp"
+
+class Lz {
+private:
+    enum {
+        HASH_BITS   = 12,
+        MATCH_MIN   = 4,
+        OFFSET_MAX  = 0xffff,
+    };
+
+public:
+    static size_t compress(const char*, size_t, char*, size_t);
+
+    static size_t decompress(const char*, size_t, char*, size_t);
+};
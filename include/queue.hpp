@@ -28,10 +28,11 @@ class Queue
 {
     private:
         T *headptr;
+        size_t count;
 
     public:
         ALWAYS_INLINE
-        inline Queue() : headptr (nullptr) {}
+        inline Queue() : headptr (nullptr), count (0) {}
 
         ALWAYS_INLINE
         inline T *head() const { return headptr; }
@@ -42,6 +43,7 @@ class Queue
         ALWAYS_INLINE
         inline void enqueue (T *t)
         {
+            count++;
             if (!headptr)
                 headptr = t->prev = t->next = t;
             else {
@@ -54,6 +56,7 @@ class Queue
         ALWAYS_INLINE
         inline void enhead (T *t)
         {
+            count++;
             if (!headptr)
                 headptr = t->prev = t->next = t;
             else {
@@ -66,21 +69,26 @@ class Queue
         }
 
         /**
-         * 
-         * @return the size of the queue
+         * Inserts t right before pos, which is in the queue
+         * @param t
+         * @param pos
          */
         ALWAYS_INLINE
-        inline size_t size ()
+        inline void insert_before (T *t, T *pos)
         {
-            T *c = headptr, *n = nullptr;
-            size_t count = 0;
-            while(c) {
-                count++;
-                n = c->next;
-                c = (n == headptr) ? nullptr : n;
-            }
-            return count;
+            count++;
+            t->next = pos;
+            t->prev = pos->prev;
+            t->next->prev = t->prev->next = t;
         }
+
+        /**
+         * 
+         * @return the size of the queue, kept up to date by enqueue, enhead, 
+         * insert_before and dequeue
+         */
+        ALWAYS_INLINE
+        inline size_t size () const { return count; }
         
         ALWAYS_INLINE
         inline bool dequeue (T *t)
@@ -99,6 +107,7 @@ class Queue
             }
 
             t->next = t->prev = nullptr;
+            count--;
 
             return true;
         }
@@ -0,0 +1,58 @@
+/*
+ * File:   reclaimer.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Reclaimer : an optional background thread which watches the eviction high
+ * watermarks and evicts old logs (and defragments) before producers reach them,
+ * and packs the aging queue logs into the Cold tier, if it is enabled.
+ * Producers only fall back to inline eviction if the thread falls behind.
+ *
+ * When the thread is running, every logging call is serialized with it through
+ * Reclaimer::Guard. The guard is reentrant within a thread, so that nested calls
+ * (commit_buffer -> add_log) or a signal handler dump do not deadlock. It must
+ * be started before, and stopped after, the logging threads.
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "types.hpp"
+#include "compiler.hpp"
+#include "config.hpp"
+#include "spinlock.hpp"
+#include <pthread.h>
+
+class Reclaimer {
+private:
+    static Spinlock lock;
+    static thread_local unsigned depth;
+    static pthread_t thread;
+    static unsigned period;
+    static void* run(void*);
+
+public:
+    static bool active;
+
+    class Guard {
+    private:
+        bool held = false;
+
+    public:
+        ALWAYS_INLINE
+        inline Guard() {
+            if(EXPECT_TRUE(!active))
+                return;
+            if(!depth++)
+                lock.lock();
+            held = true;
+        }
+
+        ALWAYS_INLINE
+        inline ~Guard() {
+            if(held && !--depth)
+                lock.unlock();
+        }
+    };
+
+    static bool start(unsigned = RECLAIM_PERIOD_US);
+    static void stop();
+};
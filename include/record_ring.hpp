@@ -0,0 +1,189 @@
+/*
+ * File:   record_ring.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Record_ring : length-prefixed records written back to back in a ring of
+ * BYTES bytes (a power of 2). Records are 8 bytes aligned and never wrap around
+ * the end of the ring : a PAD record fills the end instead. Records are
+ * referenced by their absolute number, of which only the low 32 bits matter,
+ * and an index of the offsets of the last RECORDS ones gives any of them in
+ * O(1); freeing the oldest ones advances the head. BYTES and RECORDS are the
+ * storage reserved : the ring may be resized, while empty, to a part of it.
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "types.hpp"
+#include "compiler.hpp"
+#include "string.hpp"
+#include <cassert>
+
+struct Record {
+    uint32 length;          // of the text; PAD for the padding up to the end of the ring
+    uint32 reserved;
+    uint64 tsc_delta;       // from the owning log's tsc
+
+    static const uint32 PAD = ~0u;
+
+    const char* text() const { return reinterpret_cast<const char*>(this + 1); }
+
+    char* text() { return reinterpret_cast<char*>(this + 1); }
+
+    /**
+     * Ring bytes taken by a record of length characters
+     */
+    static size_t size(size_t length) { return (sizeof(Record) + length + 7) & ~7ul; }
+};
+
+template <size_t BYTES, size_t RECORDS = BYTES / sizeof(Record)>
+class Record_ring {
+private:
+    static_assert(BYTES >= 64 && !(BYTES & (BYTES - 1)) && BYTES <= 1ul << 32,
+            "a Record_ring must be a power of 2, and its offsets fit in 32 bits");
+    static_assert(RECORDS && !(RECORDS & (RECORDS - 1)), "the record index must be a power of 2");
+
+    char bytes[BYTES] ALIGNED(8);
+    uint32 offsets[RECORDS];              // of the records, by number
+    size_t head = 0, tail = 0;            // absolute offsets of the oldest record and of the next one
+    size_t first = 0, next = 0;           // numbers of the oldest record and of the next one
+    size_t mask = BYTES - 1, index_mask = RECORDS - 1;
+
+    Record* at_offset(size_t offset) { return reinterpret_cast<Record*>(bytes + (offset & mask)); }
+
+public:
+    /**
+     * @param number : of a record, which is still in the ring for what it is worth
+     */
+    Record* at(size_t number) { return at_offset(ACCESS_ONCE(offsets[number & index_mask])); }
+
+    size_t size() const { return next - first; }
+
+    size_t capacity() const { return mask + 1; }
+
+    size_t max_size() const { return index_mask + 1; }
+
+    size_t max_length() const { return mask + 1 - sizeof(Record); }
+
+    /**
+     * Uses only the first n bytes, and the first records offsets of the index
+     * @param n : a power of 2, from 64 to BYTES
+     * @param records : a power of 2, at most RECORDS
+     */
+    void resize(size_t n, size_t records) {
+        assert(!size() && n >= 64 && !(n & (n - 1)) && n <= BYTES);
+        assert(records && !(records & (records - 1)) && records <= RECORDS);
+        mask = n - 1;
+        index_mask = records - 1;
+    }
+
+    size_t first_number() const { return first; }
+
+    size_t next_number() const { return next; }
+
+    /**
+     * Appends a record of n characters, which fill(char *text) writes in place
+     * @param n
+     * @param tsc_delta
+     * @param fill
+     * @return its number, ~0ul if there is no room for it
+     */
+    template <typename F>
+    size_t add_with(size_t n, uint64 tsc_delta, F fill) {
+        size_t size = Record::size(n), end = mask + 1 - (tail & mask), pad = end < size ? end : 0;
+        if(tail - head + pad + size > mask + 1 || next - first > index_mask)
+            return ~0ul;
+        if(pad) {
+            at_offset(tail)->length = Record::PAD;
+            tail += pad;
+        }
+        Record *r = at_offset(tail);
+        r->length = static_cast<uint32>(n);
+        r->tsc_delta = tsc_delta;
+        fill(r->text());
+        offsets[next & index_mask] = static_cast<uint32>(tail);
+        tail += size;
+        return next++;
+    }
+
+    /**
+     * Appends a record
+     * @param s
+     * @param n : length of s
+     * @param tsc_delta
+     * @return its number, ~0ul if there is no room for it
+     */
+    size_t add(const char *s, size_t n, uint64 tsc_delta) {
+        return add_with(n, tsc_delta, [&](char *text) { memcpy(text, s, n); });
+    }
+
+    /**
+     * Appends sep and then s to the newest record, moving it to the start of
+     * the ring if it would otherwise wrap around the end
+     * @param sep
+     * @param s
+     * @param n : length of s
+     * @return false if there is no room for it
+     */
+    bool extend(char sep, const char *s, size_t n) {
+        assert(size());
+        size_t number = next - 1, last = tail - Record::size(at(number)->length);
+        Record *r = at_offset(last);
+        size_t length = r->length, size = Record::size(length + 1 + n);
+        if((last & mask) + size <= mask + 1) {
+            if(last + size - head > mask + 1)
+                return false;
+        } else {
+            size_t moved = (last | mask) + 1;
+            if(moved + size - head > mask + 1)
+                return false;
+            Record *m = at_offset(moved);
+            m->tsc_delta = r->tsc_delta;
+            memcpy(m->text(), r->text(), length);
+            r->length = Record::PAD;
+            r = m;
+            last = moved;
+            offsets[number & index_mask] = static_cast<uint32>(moved);
+        }
+        r->text()[length] = sep;
+        memcpy(r->text() + length + 1, s, n);
+        r->length = static_cast<uint32>(length + 1 + n);
+        tail = last + size;
+        return true;
+    }
+
+    /**
+     * Frees the n oldest records
+     * @param n
+     */
+    void free(size_t n) {
+        assert(n <= size());
+        first += n;
+        if(first == next) {
+            head = tail;
+            return;
+        }
+        size_t offset = offsets[first & index_mask];   // low 32 bits, of a record past head
+        head += (offset - head) & mask;
+    }
+
+    /**
+     * Calls f(Record const &) on n consecutive records. Records are checked to
+     * lie within the ring, as concurrent readers may come across one being
+     * overwritten.
+     * @param number : of the first record
+     * @param n
+     * @param f
+     * @return false if a malformed record stopped the walk
+     */
+    template <typename F>
+    bool walk(size_t number, size_t n, F f) {
+        for(size_t k = 0; k < n; k++) {
+            Record *r = at(number + k);
+            size_t length = ACCESS_ONCE(r->length);
+            if(length > mask || (reinterpret_cast<char*>(r) - bytes) + Record::size(length) > mask + 1)
+                return false;
+            f(*r);
+        }
+        return true;
+    }
+};
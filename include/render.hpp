@@ -0,0 +1,88 @@
+/*
+ * File:   render.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Render : parallel rendering of dumps. The logs to be dumped are split in
+ * chunks of DUMP_CHUNK logs; a round of as many chunks as there are threads is
+ * rendered in parallel, each chunk into a Buffer_sink of its own, and the
+ * buffers are then handed over to the output sink in order, in a single batch.
+ * Output is the same as the sequential one's, while numbers formatting and
+ * text copies scale with the threads. The caller holds the Reclaimer guard,
+ * so that the logs do not change meanwhile; the renderers only read them.
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "types.hpp"
+#include "config.hpp"
+#include "sink.hpp"
+#include "util.hpp"
+#include <pthread.h>
+
+class Render {
+private:
+    enum {
+        THREADS_MAX = 64,
+    };
+
+    template <typename F>
+    struct Chunk {
+        F *render;
+        size_t from, to;
+        Buffer_sink *sink;
+        pthread_t thread;
+        bool started;
+    };
+
+    template <typename F>
+    static void* run_chunk(void *p) {
+        Chunk<F> *c = reinterpret_cast<Chunk<F>*>(p);
+        for(size_t i = c->from; i < c->to; i++)
+            (*c->render)(i, *c->sink);
+        c->sink->flush();
+        return nullptr;
+    }
+
+public:
+    /**
+     * Calls render(i, Sink &) for every i of [0, n), i.e. renders the i-th log
+     * to be dumped into the sink, and writes the outcome to out in that order
+     * @param n
+     * @param threads
+     * @param out : flushed once done
+     * @param render
+     */
+    template <typename F>
+    static void run(size_t n, unsigned threads, Sink &out, F render) {
+        threads = min(threads, static_cast<unsigned>(THREADS_MAX));
+        if(threads <= 1 || n <= DUMP_CHUNK) {
+            for(size_t i = 0; i < n; i++)
+                render(i, out);
+            out.flush();
+            return;
+        }
+        Chunk<F> chunks[THREADS_MAX];
+        for(size_t round = 0; round < n; round += threads * DUMP_CHUNK) {
+            unsigned count = 0;
+            for(size_t from = round; from < n && count < threads; from += DUMP_CHUNK, count++) {
+                Chunk<F> &c = chunks[count];
+                c = {&render, from, min(from + DUMP_CHUNK, n), new Buffer_sink, 0, false};
+                c.started = !pthread_create(&c.thread, nullptr, run_chunk<F>, &c);
+            }
+            for(unsigned k = 0; k < count; k++) {
+                Chunk<F> &c = chunks[k];
+                if(c.started)
+                    pthread_join(c.thread, nullptr);
+                if(!c.started || c.sink->failed()) {    // render it here, in turn
+                    for(size_t i = c.from; i < c.to; i++)
+                        render(i, out);
+                } else {
+                    out.put(c.sink->bytes(), c.sink->size());
+                }
+            }
+            out.flush();
+            for(unsigned k = 0; k < count; k++)
+                delete chunks[k].sink;
+        }
+    }
+};
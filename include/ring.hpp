@@ -0,0 +1,122 @@
+/*
+ * File:   ring.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Ring : fixed array of N slots (N a power of 2) used as a circular
+ * buffer. Slots are addressed by absolute, ever-growing indexes, masked into
+ * the array; [start(), cursor()) are the slots in use, oldest first. Ranges
+ * are walked as at most two contiguous segments, without any division. The
+ * ring may be resized, while empty, to use only its first slots : the others
+ * are never touched.
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "types.hpp"
+#include "compiler.hpp"
+#include <cassert>
+
+template <typename T, size_t N>
+class Ring {
+private:
+    static_assert(N && !(N & (N - 1)), "the capacity of a Ring must be a power of 2");
+
+    T slots[N];
+    size_t head = 0, tail = 0; // absolute indexes of the oldest slot in use and of the next one
+    size_t mask = N - 1;       // capacity - 1
+
+public:
+    ALWAYS_INLINE
+    inline T& operator[](size_t i) { return slots[i & mask]; }
+
+    ALWAYS_INLINE
+    inline T const& operator[](size_t i) const { return slots[i & mask]; }
+
+    /**
+     * @param i : absolute index
+     * @return the position of its slot in the array
+     */
+    size_t slot(size_t i) const { return i & mask; }
+
+    size_t capacity() const { return mask + 1; }
+
+    /**
+     * Uses only the first n slots
+     * @param n : a power of 2, at most N
+     */
+    void resize(size_t n) {
+        assert(empty() && n && !(n & (n - 1)) && n <= N);
+        mask = n - 1;
+    }
+
+    size_t start() const { return __atomic_load_n(&head, __ATOMIC_ACQUIRE); }
+
+    size_t cursor() const { return __atomic_load_n(&tail, __ATOMIC_ACQUIRE); }
+
+    size_t size() const { return tail - head; }
+
+    bool empty() const { return tail == head; }
+
+    bool full() const { return tail - head == mask + 1; }
+
+    /**
+     * The slot the next push() publishes; it may still hold a stale value
+     */
+    T& next() { return slots[tail & mask]; }
+
+    /**
+     * Publishes the n slots following cursor(), once written
+     * @param n
+     */
+    void push(size_t n = 1) {
+        assert(size() + n <= capacity());
+        __atomic_store_n(&tail, tail + n, __ATOMIC_RELEASE);
+    }
+
+    /**
+     * Drops the n oldest slots, whose content is left to the caller
+     * @param n
+     */
+    void pop(size_t n = 1) {
+        assert(n <= size());
+        __atomic_store_n(&head, head + n, __ATOMIC_RELEASE);
+    }
+
+    /**
+     * Calls f(T &, size_t index) on the slots of absolute indexes [from, to), in order
+     * @param from
+     * @param to
+     * @param f
+     */
+    template <typename F>
+    void range(size_t from, size_t to, F f) {
+        while(from < to) {
+            size_t i = from & mask, n = to - from < mask + 1 - i ? to - from : mask + 1 - i;
+            T *p = slots + i;
+            for(size_t k = 0; k < n; k++)
+                f(p[k], from + k);
+            from += n;
+        }
+    }
+
+    /**
+     * Calls f(T &, size_t index) on the slots of absolute indexes [from, to),
+     * from the newest to the oldest
+     * @param from
+     * @param to
+     * @param f
+     */
+    template <typename F>
+    void range_reverse(size_t from, size_t to, F f) {
+        while(from < to) {
+            size_t i = (to - 1) & mask, n = to - from < i + 1 ? to - from : i + 1;
+            T *p = slots + i;
+            for(size_t k = 0; k < n; k++)
+                f(*(p - k), to - 1 - k);
+            to -= n;
+        }
+    }
+
+    template <typename F>
+    void for_each(F f) { range(head, tail, f); }
+};
@@ -0,0 +1,43 @@
+/*
+ * File:   search.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Search : substring search over the stored log titles and entries, in
+ * place in the Block heap. Strings are scanned 16 bytes at a time with SSE2,
+ * by comparing both the first and the last byte of the pattern, so that only
+ * a few candidate positions have to be verified.
+ * find_token() matches whole tokens only, and skips the Logstore segments
+ * whose zone map (see Zone) rules the phrase or the tsc bound out.
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "types.hpp"
+
+struct Search_match {
+    size_t numero;          // of the log
+    size_t entry;           // index of the entry in the log, Search::TITLE for its title
+    uint64 tsc;             // of the log
+    bool store;             // Logstore log
+    bool cold;              // Cold log
+};
+
+struct Search_bound {
+    uint64 tsc_from = 0, tsc_to = ~0ull;
+    size_t numero_from = 0, numero_to = ~0ul;
+};
+
+class Search {
+public:
+    static const size_t TITLE = ~0ul;
+
+    static const char* scan(const char*, size_t, const char*, size_t);
+
+    static size_t find(char const* const*, size_t, Search_match*, size_t,
+            Search_bound const & = Search_bound());
+
+    static size_t find(char const*, Search_match*, size_t, Search_bound const & = Search_bound());
+
+    static size_t find_token(char const*, Search_match*, size_t,
+            Search_bound const & = Search_bound());
+};
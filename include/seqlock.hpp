@@ -0,0 +1,53 @@
+/*
+ * File:   seqlock.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Seqcount : sequence counter letting lock-free readers detect that the
+ * data they read was modified underneath them. Writers, already serialized by
+ * the Reclaimer lock, make it odd while they write; readers retry, or drop
+ * what they read, when the count changed or was odd.
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "types.hpp"
+#include "compiler.hpp"
+
+class Seqcount {
+private:
+    uint32 seq = 0;
+
+public:
+    ALWAYS_INLINE
+    inline void write_begin() {
+        __atomic_store_n(&seq, seq + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+
+    ALWAYS_INLINE
+    inline void write_end() {
+        __atomic_store_n(&seq, seq + 1, __ATOMIC_RELEASE);
+    }
+
+    /**
+     * Waits for the writer, if any, to be done
+     * @return the count to hand over to read_retry()
+     */
+    ALWAYS_INLINE
+    inline uint32 read_begin() const {
+        uint32 s;
+        while((s = __atomic_load_n(&seq, __ATOMIC_ACQUIRE)) & 1)
+            asm volatile ("pause" : : : "memory");
+        return s;
+    }
+
+    /**
+     * @param s : returned by read_begin()
+     * @return true if what was read since read_begin() may be inconsistent
+     */
+    ALWAYS_INLINE
+    inline bool read_retry(uint32 s) const {
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        return __atomic_load_n(&seq, __ATOMIC_RELAXED) != s;
+    }
+};
@@ -0,0 +1,90 @@
+/*
+ * File:   sink.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Sink : where dumps are written to. Strings already stored in the Block
+ * heap are not copied, they are gathered by reference; only the few formatted
+ * numbers go through a staging buffer. Gathered bytes are handed over to emit()
+ * in large batches, which a concrete sink implements (Fd_sink uses writev).
+ * Referenced strings must not change until flush(), so a dump flushes before
+ * it returns.
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "types.hpp"
+#include "compiler.hpp"
+#include "config.hpp"
+#include <sys/uio.h>
+
+class Sink {
+private:
+    enum {
+        IOV_NUM     = 1024,             // max iovecs handed over at once
+        STAGING     = 16 * PAGE_SIZE,   // formatted bytes buffer
+        FORMAT_MAX  = 2 * STR_MAX_LENGTH,
+    };
+    iovec iov[IOV_NUM];
+    int iov_count = 0;
+    char staging[STAGING];
+    size_t staging_used = 0;
+
+protected:
+    virtual void emit(const iovec*, int) = 0;
+
+public:
+    static Sink& out();
+
+    virtual ~Sink() {}
+
+    void put(const char*, size_t);
+
+    void put(const char*);
+
+    FORMAT (2,3)
+    void format(char const *, ...);
+
+    void flush();
+};
+
+/**
+ * Writes to a file descriptor, a batch of gathered strings per writev call
+ */
+class Fd_sink : public Sink {
+private:
+    int fd;
+    bool error = false;
+
+protected:
+    void emit(const iovec*, int);
+
+public:
+    explicit Fd_sink(int f) : fd(f) {}
+
+    bool failed() const { return error; }
+
+    ~Fd_sink() { flush(); }
+};
+
+/**
+ * Copies to a heap buffer, which grows as needed, e.g. to render a part of a
+ * dump ahead of its turn (see Render)
+ */
+class Buffer_sink : public Sink {
+private:
+    char *data = nullptr;
+    size_t used = 0, capacity = 0;
+    bool error = false;
+
+protected:
+    void emit(const iovec*, int);
+
+public:
+    ~Buffer_sink();
+
+    const char* bytes() const { return data; }
+
+    size_t size() const { return used; }
+
+    bool failed() const { return error; }
+};
@@ -0,0 +1,117 @@
+/*
+ * File:   slot_ring.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Slot_ring : log entries in fixed 128 bytes slots, aligned on cache lines,
+ * in a ring of BYTES bytes (a power of 2). Each slot holds the tsc delta, an
+ * inline length byte and up to Entry_slot::TEXT characters; a Log_store rejects,
+ * and counts, longer entries. Adding an entry is a single copy into one cache
+ * line, its offset is the slot's absolute index, and freeing the oldest ones
+ * advances the head. It is a drop-in replacement of the Record_ring for the
+ * entries of a Log_store, for entries made by add_log_entry, which are bounded
+ * by STR_MAX_LENGTH, and may likewise be resized to a part of its BYTES while
+ * empty :
+ *
+ *     Log_store<LOGS, ENTRY_BYTES, TITLE_BYTES, Slot_ring>
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "types.hpp"
+#include "compiler.hpp"
+#include "string.hpp"
+#include <cassert>
+
+struct Entry_slot {
+    static const size_t SIZE = 128, TEXT = SIZE - sizeof(uint64) - sizeof(uint8);
+
+    uint64 tsc_delta;       // from the owning log's tsc
+    uint8 length;
+    char bytes[TEXT];
+
+    const char* text() const { return bytes; }
+} ALIGNED(128);
+
+static_assert(sizeof(Entry_slot) == Entry_slot::SIZE && STR_MAX_LENGTH <= Entry_slot::TEXT + 1,
+        "an entry slot is a 128 bytes cache line, which holds any entry formatted by add_log_entry");
+
+template <size_t BYTES>
+class Slot_ring {
+private:
+    static_assert(BYTES >= Entry_slot::SIZE && !(BYTES & (BYTES - 1)),
+            "a Slot_ring must be a power of 2, of at least one slot");
+
+    static constexpr size_t COUNT = BYTES / Entry_slot::SIZE;
+
+    Entry_slot slots[COUNT];
+    size_t head = 0, tail = 0; // absolute indexes of the oldest slot and of the next one
+    size_t mask = COUNT - 1;
+
+public:
+    Entry_slot* at(size_t offset) { return slots + (offset & mask); }
+
+    size_t size() const { return tail - head; }
+
+    size_t capacity() const { return (mask + 1) * Entry_slot::SIZE; }
+
+    size_t max_size() const { return mask + 1; }
+
+    size_t max_length() const { return Entry_slot::TEXT; }
+
+    /**
+     * Uses only the first n bytes of slots
+     * @param n : a power of 2, from Entry_slot::SIZE to BYTES
+     * @param records : ignored, slots being their own index
+     */
+    void resize(size_t n, size_t) {
+        assert(!size() && n >= Entry_slot::SIZE && !(n & (n - 1)) && n <= BYTES);
+        mask = n / Entry_slot::SIZE - 1;
+    }
+
+    /**
+     * Writes an entry in the next slot
+     * @param s
+     * @param n : length of s, at most max_length()
+     * @param tsc_delta
+     * @return its offset, ~0ul if every slot is in use
+     */
+    size_t add(const char *s, size_t n, uint64 tsc_delta) {
+        assert(n <= Entry_slot::TEXT);
+        if(tail - head > mask)
+            return ~0ul;
+        Entry_slot *e = at(tail);
+        e->tsc_delta = tsc_delta;
+        e->length = static_cast<uint8>(n);
+        memcpy(e->bytes, s, n);
+        return tail++;
+    }
+
+    /**
+     * Frees the n oldest entries
+     * @param n
+     */
+    void free(size_t n) {
+        assert(n <= size());
+        head += n;
+    }
+
+    /**
+     * Calls f(Entry_slot const &) on n consecutive entries, prefetching the
+     * next one
+     * @param offset : of the first entry
+     * @param n
+     * @param f
+     * @return false if a malformed slot stopped the walk
+     */
+    template <typename F>
+    bool walk(size_t offset, size_t n, F f) {
+        for(size_t k = 0; k < n; k++) {
+            Entry_slot *e = at(offset + k);
+            __builtin_prefetch(at(offset + k + 1));
+            if(ACCESS_ONCE(e->length) > Entry_slot::TEXT)
+                return false;
+            f(*e);
+        }
+        return true;
+    }
+};
@@ -0,0 +1,22 @@
+/*
+ * File:   snapshot.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Snapshot : serializes the cold logs (Cold), the queue logs (Log) and the
+ * store logs (Logstore) in the binary format of snapshot_format.hpp. The header
+ * and record tables are built first, then stored strings are gathered by
+ * reference, so the whole snapshot goes out in a single sequential writev
+ * stream.
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "snapshot_format.hpp"
+#include "sink.hpp"
+
+class Snapshot {
+public:
+    static bool write(Sink&);
+
+    static bool save(char const*);
+};
@@ -0,0 +1,56 @@
+/*
+ * File:   snapshot_format.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The snapshot binary format, shared by Snapshot (the writer) and the offline
+ * reader tool. A snapshot is laid out as :
+ *
+ *   Snapshot_header
+ *   Snapshot_log   [log_count]     at logs_offset, in creation order
+ *   Snapshot_entry [entry_count]   at entries_offset, grouped by log
+ *   string bytes                   at data_offset, not null terminated
+ *
+ * All offsets are from the start of the file and all records are 8 bytes
+ * aligned, so that a reader can mmap the file and index it directly. Cold
+ * (Cold) logs come first, flagged SNAPSHOT_COLD, then queue (Log) logs, then
+ * store (Logstore) logs, flagged SNAPSHOT_STORE.
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "types.hpp"
+
+#define SNAPSHOT_MAGIC      0x50414e5347544c53ull  // "SLTGSNAP"
+#define SNAPSHOT_VERSION    2
+#define SNAPSHOT_STORE      1u                     // Snapshot_log flags
+#define SNAPSHOT_COLD       2u
+
+struct Snapshot_header {
+    uint64 magic;
+    uint32 version;
+    uint32 header_size;
+    uint64 log_count;
+    uint64 entry_count;
+    uint64 logs_offset;
+    uint64 entries_offset;
+    uint64 data_offset;
+    uint64 size;            // of the whole snapshot
+};
+
+struct Snapshot_log {
+    uint64 numero;
+    uint64 tsc;
+    uint64 first_entry;     // index in the Snapshot_entry table
+    uint64 title;           // offset of the title bytes
+    uint32 title_length;
+    uint32 entry_count;
+    uint32 flags;
+    uint32 reserved;
+};
+
+struct Snapshot_entry {
+    uint64 offset;          // of the entry bytes
+    uint64 tsc_delta;       // from the owning log's tsc
+    uint32 length;
+    uint32 reserved;
+};
@@ -0,0 +1,75 @@
+/*
+ * File:   spill.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Spill : optional disk overflow of the evicted logs. The titles and entries
+ * of the logs which are about to be freed, from Log, any Log_store, and the
+ * oldest cold logs (Cold), are copied as journal records (see journal_format.hpp)
+ * into an in-memory staging ring. A background thread appends what has been
+ * staged to size-capped files, path.0 to path.(SPILL_FILES - 1), in large
+ * sequential writes, and rotates through them, overwriting the oldest one.
+ *
+ * Producers never wait for the disk : a log which does not fit in the staging
+ * ring is dropped as a whole, and counted. Spill files are read with tools/journal_reader.
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "journal_format.hpp"
+#include "compiler.hpp"
+#include "config.hpp"
+#include <pthread.h>
+
+class Spill {
+private:
+    static char *ring;
+    static uint64 size, head, tail;     // monotonic byte counts, as those of the Journal
+    static uint64 staged;               // head, once the records being staged are committed
+    static size_t dropped;              // logs
+    static bool dropping;               // the log being staged did not fit
+    static pthread_t thread;
+    static bool running;
+    static int fd;
+    static char path[256];
+    static size_t file_bytes, files, written;
+    static uint64 sequence;
+    static void write(uint32, uint64, const char*, size_t);
+    static bool rotate();
+    static void put(uint64, uint64);
+    static void drain();
+    static void* run(void*);
+
+public:
+    ALWAYS_INLINE
+    static inline bool on() { return EXPECT_FALSE(ring != nullptr); }
+
+    ALWAYS_INLINE
+    static inline void record(uint32 type, uint64 tsc, const char* s, size_t length) {
+        if(on())
+            write(type, tsc, s, length);
+    }
+
+    /**
+     * Hands the records staged since the last call over to the writer thread,
+     * once a whole log has been staged, so that files only hold whole logs. If
+     * any of them did not fit, they are all dropped instead.
+     */
+    ALWAYS_INLINE
+    static inline void commit() {
+        if(!on())
+            return;
+        if(EXPECT_FALSE(dropping)) {
+            staged = head;
+            dropping = false;
+            dropped++;
+        } else
+            __atomic_store_n(&head, staged, __ATOMIC_RELEASE);
+    }
+
+    static bool open(char const*, size_t = SPILL_FILE_BYTES, size_t = SPILL_FILES, 
+            unsigned = SPILL_ORDER);
+
+    static void close();
+
+    static size_t lost() { return dropped; }
+};
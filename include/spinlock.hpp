@@ -0,0 +1,47 @@
+/*
+ * Generic Spinlock
+ *
+ * Copyright (C) 2009-2011 Udo Steinberg <udo@hypervisor.org>
+ * Economic rights: Technische Universitaet Dresden (Germany)
+ *
+ * Copyright (C) 2012 Udo Steinberg, Intel Corporation.
+ *
+ * This file is part of the NOVA microhypervisor.
+ *
+ * NOVA is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * NOVA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License version 2 for more details.
+ */
+
+#pragma once
+
+#include "compiler.hpp"
+
+class Spinlock
+{
+    private:
+        bool val;
+
+    public:
+        ALWAYS_INLINE
+        inline Spinlock() : val (false) {}
+
+        ALWAYS_INLINE
+        inline void lock()
+        {
+            while (__atomic_exchange_n (&val, true, __ATOMIC_ACQUIRE))
+                while (__atomic_load_n (&val, __ATOMIC_RELAXED))
+                    asm volatile ("pause" : : : "memory");
+        }
+
+        ALWAYS_INLINE
+        inline void unlock()
+        {
+            __atomic_store_n (&val, false, __ATOMIC_RELEASE);
+        }
+};
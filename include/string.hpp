@@ -25,6 +25,7 @@
 #include "queue.hpp"
 #include <cstdlib>
 #include <cstdarg>
+#include <sys/mman.h>
 
 extern "C" NONNULL
 inline void *memcpy(void *dst, const void *src, size_t n) {
@@ -131,19 +132,29 @@ inline bool strmatch (char const *s1, char const *s2, size_t n)
 }
 
 /**
- * fonction a n'utiliser que pour comparer des tailles multiples de 4 et page aligned ex: 4ko
+ * Compares len bytes, of any alignment : by double words as long as they are
+ * equal, then byte by byte from the last double word compared
  * @param s1
  * @param s2
  * @param len
- * @return 
+ * @return 0 if they are equal, else the difference of the first bytes which differ
  */
 extern "C" NONNULL
 inline int memcmp(const void *s1, const void *s2, size_t len) {
-    len /=4; // cmpsl compare double word (4 bytes)
-    int diff = 0;
-    asm volatile ("repe; cmpsl; movl %%ecx, %0;"
-                : "=qm" (diff), "+D" (s1), "+S" (s2), "+c" (len));
-    return diff;
+    const uint8 *p1 = reinterpret_cast<const uint8*>(s1), *p2 = reinterpret_cast<const uint8*>(s2);
+    size_t dwords = len / 4, left = dwords;
+    if(dwords) {
+        asm volatile ("cld; repe; cmpsl"
+                    : "+D" (p1), "+S" (p2), "+c" (left) :: "cc", "memory");
+        // The last double word compared may be the one which differs
+        p1 -= 4;
+        p2 -= 4;
+        len -= (dwords - left - 1) * 4;
+    }
+    for(; len; p1++, p2++, len--)
+        if(*p1 != *p2)
+            return *p1 - *p2;
+    return 0;
 }
 
 /*
@@ -189,9 +200,10 @@ class Block {
     friend class Queue<Block>;
 private:
     static void *memory;       // Our heap start pointer
+    static void *scratch;      // as big as the heap, where defragment() gathers the used blocks
     static unsigned short memory_order; // 2^memory_order *4Ko will be dedicated to this heap 
     static size_t tour, memory_size, free_memory;  
-    static bool reallocated, initialized;
+    static bool reallocated, initialized, ordered;
     static Block* cursor;
     static Queue<Block> free_blocks, used_blocks;  // circular list of available blocks
     
@@ -212,10 +224,20 @@ private:
     /**
      * Called when the first block is requested to allocate the heap.
      * At this stage, free_blocks is constitued of one big block of 
-     * memory_size ==  2^memory_order *4Ko 
+     * memory_size ==  2^memory_order *4Ko; memory_order is taken from the
+     * LOG_HEAP_ORDER environment variable, unless set_heap_order() was called.
+     * The scratch area of defragment() is only reserved here : its pages are
+     * backed while it runs, and given back afterwards
      */
     static void initialize() { 
+        const char *order = getenv("LOG_HEAP_ORDER");
+        if(order && !ordered)
+            set_heap_order(static_cast<unsigned>(strtoul(order, nullptr, 0)));
         memory = malloc (memory_size);
+        scratch = mmap(nullptr, memory_size, PROT_READ | PROT_WRITE, 
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if(scratch == MAP_FAILED)
+            scratch = nullptr;
         cursor = new Block(reinterpret_cast<char*>(memory), memory_size, true);
         initialized = true;
     }
@@ -248,8 +270,13 @@ public:
     static Block* realloc(size_t);    
     static Block* alloc_from_cursor(size_t);    
     static size_t left();
+    static size_t largest();
     static void print();
     static void defragment();
+    static bool compact();
+    static size_t heap_size() { return memory_size; }
+    static bool set_heap_order(unsigned);
+    static size_t free_bytes() { return ACCESS_ONCE(free_memory); }
 };
 
 class String {
@@ -265,7 +292,8 @@ private:
     };
     size_t length;
     Block* buffer = nullptr;
-    static unsigned count;
+    static thread_local unsigned count; // characters formatted by the current vprint()
+    static thread_local unsigned room;  // characters it may still write
     static void print_num (uint64, unsigned, unsigned, unsigned, void**);
     static void print_str (char const *, unsigned, unsigned, void**);
     static int vprintf_help(int , void **);
@@ -282,6 +310,8 @@ public:
 
     String(const char *);
     ~String() { buffer->~Block(); }
+    size_t size() { return buffer ? buffer->size : 0; } // heap bytes in use
+    size_t get_length() { return length; }
     char* get_string() {
         if(buffer)
             return buffer->start;
@@ -295,4 +325,13 @@ public:
     
     FORMAT (2,3)
     static unsigned print (char *, char const *, ...);
+
+    FORMAT (3,4)
+    static unsigned print (char *, size_t, char const *, ...);
+
+    FORMAT (2,0)
+    static unsigned vprint (char *, char const *, va_list);
+
+    FORMAT (3,0)
+    static unsigned vprint (char *, size_t, char const *, va_list);
 };
\ No newline at end of file
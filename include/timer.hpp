@@ -0,0 +1,49 @@
+/*
+ * File:   timer.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Timer : cheap cycle-accurate timestamps for logs and log entries. Time is
+ * read with rdtsc; the cycle/microsecond ratio is only needed to convert
+ * durations, so it is set up by the first conversion, or by the Reclaimer
+ * thread when it starts : from CPUID leaf 0x15 when the processor reports its
+ * tsc frequency, else by calibration against clock_gettime. A process which
+ * never converts a duration never pays for it
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "types.hpp"
+#include "compiler.hpp"
+#include <mutex>
+
+ALWAYS_INLINE
+static inline uint64 rdtsc()
+{
+    mword h, l;
+    asm volatile ("rdtsc" : "=a" (l), "=d" (h));
+    return static_cast<uint64>(h) << 32 | l;
+}
+
+class Timer {
+private:
+    static uint64 tsc_per_us;
+    static std::once_flag calibrated;
+    static uint64 measure();
+    static uint64 ratio();
+
+public:
+    static void calibrate();
+
+    ALWAYS_INLINE
+    static inline uint64 now() { return rdtsc(); }
+
+    /**
+     * Delta of now from base, as stored in a log entry
+     * @param base : the owning log's timestamp
+     */
+    ALWAYS_INLINE
+    static inline uint64 delta(uint64 base) { return rdtsc() - base; }
+
+    static uint64 us_to_tsc(uint64);
+    static uint64 tsc_to_us(uint64);
+};
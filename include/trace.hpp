@@ -0,0 +1,178 @@
+/*
+ * File:   trace.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Trace : levels and categories on top of the logging API. Calls below
+ * LOG_LEVEL_MIN are removed at compile time, arguments included; the others
+ * test one bit of a per-level category mask before evaluating anything.
+ *
+ *     TRACE(LOG_DEBUG, 3, Log::add_log_entry, "exit %u", reason);
+ *     TRACE_IF(LOG_INFO, 3, Logstore::add_log(title));
+ *
+ * Hot call sites can further be sampled (1 in N) or rate limited (token
+ * bucket), per thread, before any formatting or allocation. Each site counts
+ * the events it suppressed; the counts are reported by the dumps.
+ *
+ *     TRACE_SAMPLED(100, LOG_DEBUG, 3, Log::add_log_entry, "irq %u", vector);
+ *     TRACE_LIMITED(1000, 50, LOG_INFO, 3, Logstore::add_log, "exit %u", reason);
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "types.hpp"
+#include "compiler.hpp"
+#include "config.hpp"
+#include "timer.hpp"
+#include "string.hpp"
+#include <cstdarg>
+
+class Sink;
+
+/*
+ * A sampled or rate limited call site. Sites are constant-initialized statics,
+ * and only join the list of sites to report once they have suppressed events.
+ */
+class Trace_site {
+private:
+    static Trace_site *sites;
+
+    Trace_site *next = nullptr;
+    char const *file;
+    unsigned line;
+    bool registered = false;
+    uint64 suppressed = 0;
+
+    void add_suppressed(uint32);
+
+public:
+    constexpr Trace_site(char const *f, unsigned l) : file(f), line(l) {}
+
+    /**
+     * Per thread state of a site; suppressed events are folded into the site's
+     * counter in batches, so that suppression does not bounce its cache line
+     */
+    struct Gate {
+        uint32 tick;        // events left to skip before the next sample
+        uint32 pending;     // suppressed, not yet folded into the site
+        uint64 interval;    // tsc between two tokens
+        uint64 tat;         // theoretical arrival time of the next event
+    };
+
+    enum { FOLD = 256 };
+
+    ALWAYS_INLINE
+    inline bool suppress(Gate &g) {
+        if(EXPECT_FALSE(++g.pending == FOLD)) {
+            add_suppressed(g.pending);
+            g.pending = 0;
+        }
+        return false;
+    }
+
+    ALWAYS_INLINE
+    inline bool admit(Gate &g) {
+        if(g.pending) {
+            add_suppressed(g.pending);
+            g.pending = 0;
+        }
+        return true;
+    }
+
+    /**
+     * One event out of n goes through, starting with the first one
+     */
+    ALWAYS_INLINE
+    inline bool sample(Gate &g, uint32 n) {
+        if(g.tick) {
+            g.tick--;
+            return suppress(g);
+        }
+        g.tick = n - 1;
+        return admit(g);
+    }
+
+    bool limit(Gate&, uint32, uint32);
+
+    static void report(Sink&);
+};
+
+enum Log_level {
+    LOG_TRACE,
+    LOG_DEBUG,
+    LOG_INFO,
+    LOG_WARN,
+    LOG_ERROR,
+    LOG_LEVELS
+};
+
+class Trace {
+private:
+    static_assert(LOG_CATEGORIES <= 32, "a category mask is 32 bits wide");
+
+    static uint32 mask[LOG_LEVELS]; // bit c : category c is logged at this level
+
+public:
+    static constexpr uint32 ALL = LOG_CATEGORIES == 32 ? ~0u : (1u << LOG_CATEGORIES) - 1;
+
+    static constexpr bool compiled(unsigned level) { return level < LOG_LEVELS && level + 1 > LOG_LEVEL_MIN; }
+
+    ALWAYS_INLINE
+    static inline bool enabled(unsigned level, unsigned category) {
+        return EXPECT_FALSE(ACCESS_ONCE(mask[level]) & (1u << category));
+    }
+
+    static void enable(unsigned, unsigned = LOG_TRACE);
+
+    static void disable(unsigned);
+
+    static void set_level(unsigned, uint32 = ALL);
+
+    /**
+     * Formats the message with String::vprint, as the logging API formats its
+     * entries (truncated to STR_MAX_LENGTH - 1 characters), and hands
+     * it over to F, one of the add_log/add_log_entry/append_log_info/..._in_buffer
+     * functions of Log or Logstore
+     * @param fmt
+     */
+    template <void (*F)(const char*)>
+    FORMAT(1, 2)
+    static void call(char const *fmt, ...) {
+        char buffer[STR_MAX_LENGTH];
+        va_list args;
+        va_start(args, fmt);
+        String::vprint(buffer, sizeof(buffer), fmt, args);
+        va_end(args);
+        F(buffer);
+    }
+};
+
+/*
+ * Runs the statement X only if level L is compiled in and category C is
+ * enabled at that level
+ */
+#define TRACE_IF(L, C, X...)                                \
+    do {                                                    \
+        if constexpr (Trace::compiled(L))                   \
+            if(Trace::enabled((L), (C))) { X; }             \
+    } while(0)
+
+/*
+ * Formats and logs through F (e.g. Log::add_log) at level L in category C
+ */
+#define TRACE(L, C, F, X...)    TRACE_IF(L, C, Trace::call<F>(X))
+
+/*
+ * Logs one event out of N at the call site
+ */
+#define TRACE_SAMPLED(N, L, C, F, X...)                                         \
+    TRACE_IF(L, C, static Trace_site trace_site(__FILE__, __LINE__);            \
+            static thread_local Trace_site::Gate trace_gate;                    \
+            if(trace_site.sample(trace_gate, (N))) Trace::call<F>(X))
+
+/*
+ * Logs at most R events per second at the call site, with bursts of up to B
+ */
+#define TRACE_LIMITED(R, B, L, C, F, X...)                                      \
+    TRACE_IF(L, C, static Trace_site trace_site(__FILE__, __LINE__);            \
+            static thread_local Trace_site::Gate trace_gate;                    \
+            if(trace_site.limit(trace_gate, (R), (B))) Trace::call<F>(X))
@@ -0,0 +1,70 @@
+/*
+ * File:   zone.hpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Zone : summary of a segment of ZONE_LOGS consecutive Logstore logs, kept
+ * up to date as logs, title appends and entries are committed : min/max tsc
+ * and a Bloom filter of the tokens (runs of letters, digits and '_') seen in
+ * titles and entries. The sequence range is implicit : a segment holds the
+ * absolute indexes [first, first + ZONE_LOGS), and a store log's number is its
+ * index minus the Logstore start. Queries use them to skip whole segments which
+ * cannot match. Segments partially evicted keep their summary, which is then
+ * a conservative superset. Only the zones of the Logstore capacity are used,
+ * and unused ones are all zeros, so that they cost nothing until then.
+ *
+ * Created on 19 octobre 2026
+ */
+#pragma once
+
+#include "types.hpp"
+#include "compiler.hpp"
+#include "config.hpp"
+
+class Zone {
+private:
+    enum {
+        ZONES       = LOG_MAX / ZONE_LOGS,
+        BLOOM_WORDS = ZONE_BLOOM_BITS / 64,
+    };
+    static_assert(LOG_MAX % ZONE_LOGS == 0, "a log slot must map to a single zone");
+    static_assert(ZONE_BLOOM_BITS % 64 == 0 && !(ZONE_BLOOM_BITS & (ZONE_BLOOM_BITS - 1)),
+            "ZONE_BLOOM_BITS must be a power of 2");
+
+    static Zone zones[ZONES];
+    static size_t mask;     // zones in use - 1
+
+    size_t end = 0;         // absolute index past the segment's last log; 0 while unused
+    uint64 tsc_min = 0, tsc_max = 0;
+    uint64 bloom[BLOOM_WORDS] = {};
+
+    void add(uint64 hash) {
+        for(unsigned k = 0; k < 3; k++, hash = (hash >> 21) | (hash << 43))
+            bloom[(hash / 64) % BLOOM_WORDS] |= 1ull << (hash % 64);
+    }
+
+    bool has(uint64 hash) const {
+        for(unsigned k = 0; k < 3; k++, hash = (hash >> 21) | (hash << 43))
+            if(!(bloom[(hash / 64) % BLOOM_WORDS] & (1ull << (hash % 64))))
+                return false;
+        return true;
+    }
+
+    static Zone& of(size_t index) { return zones[(index / ZONE_LOGS) & mask]; }
+
+public:
+    ALWAYS_INLINE
+    static inline bool is_token(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    }
+
+    static size_t tokens(const char*, size_t, uint64*, size_t);
+
+    static void add_log(size_t, uint64, const char*, size_t);
+
+    static void add_text(size_t, const char*, size_t);
+
+    static bool may_match(size_t, uint64, uint64, const uint64*, size_t);
+
+    static size_t segment(size_t index) { return index - index % ZONE_LOGS; }
+
+    static void resize(size_t);
+};
@@ -13,21 +13,30 @@
 
 #include <cstdlib>
 #include <cstdio>
-#include "log.hpp"
+#include "logger.hpp"
+#include "snapshot.hpp"
 #include <csignal> 
 
 using namespace std;
 
+static char const *snapshot_path = nullptr;
+
 void signal_handler(int signal_num ) { 
-   Log::dump("CTRL C", false, 0); 
+   if(snapshot_path)
+       Snapshot::save(snapshot_path);
+   else
+       Logger::dump("CTRL C", false, 0); 
    exit(0);
 } 
   
 /*
- * 
+ * Usage : main [snapshot file]; on CTRL C, logs are dumped to the standard 
+ * output, or saved to the snapshot file if one is given
  */
 int main(int argc, char** argv) {
     Log::log_on = true;
+    if(argc > 1)
+        snapshot_path = argv[1];
     signal(SIGINT, signal_handler);   
     int i = 0;
     char chaine[3][STR_MAX_LENGTH] = {"Première phrase courte", 
@@ -36,20 +45,20 @@ int main(int argc, char** argv) {
     while(1){
         char s[STR_MAX_LENGTH];
         snprintf(s, STR_MAX_LENGTH, "PD %d EC %d", i, i);
-        Log::add_log_in_buffer(s);
+        Logger::add_log_in_buffer(s);
         int n = rand()%10, l = n ? rand()%n : n; 
         for(int j=0; j<n; j++){
             int k = rand()%3;
             char d[STR_MAX_LENGTH];
             snprintf(d, STR_MAX_LENGTH, "Log_entry %d %s", j, chaine[k]);
-            Log::add_entry_in_buffer(d);
+            Logger::add_entry_in_buffer(d);
             if(j == l){
                 char s[STR_MAX_LENGTH];
                 snprintf(s, STR_MAX_LENGTH, "Log appended %d", l);
-                Log::add_log_in_buffer(s);
+                Logger::add_log_in_buffer(s);
             }
         }
-        Log::commit_buffer();
+        Logger::commit_buffer();
         i++;
     }
 }
@@ -0,0 +1,277 @@
+/*
+ * File:   aggregate.cpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Aggregate : single pass group by over the retained logs
+ *
+ * Created on 19 octobre 2026
+ */
+
+#include "aggregate.hpp"
+#include "log_walk.hpp"
+#include "reclaimer.hpp"
+#include "search.hpp"
+#include "zone.hpp"
+#include "cold.hpp"
+#include <pthread.h>
+
+/**
+ * Groups, in open addressing over capacity slots; empty slots have a count of 0
+ */
+struct Group_table {
+    Aggregate_group *groups;
+    size_t capacity, used = 0, missed = 0;
+
+    Group_table(Aggregate_group *g, size_t m) : groups(g), capacity(m) {
+        memset(groups, 0, capacity * sizeof(Aggregate_group));
+    }
+
+    /**
+     * @param hash
+     * @param key
+     * @param length
+     * @return the group of the key, a new one if need be; nullptr if there is no room
+     */
+    Aggregate_group* find(uint64 hash, const char *key, size_t length) {
+        length = min(length, Aggregate_group::KEY);
+        for(size_t k = 0, i = hash % capacity; k < capacity; k++, i = i + 1 < capacity ? i + 1 : 0) {
+            Aggregate_group &g = groups[i];
+            if(!g.count) {
+                if(used == capacity)
+                    return nullptr;
+                used++;
+                g.hash = hash;
+                g.tsc_min = ~0ull;
+                memcpy(g.key, key, length);
+                g.key_length = length;
+                return &g;
+            }
+            if(g.hash == hash && g.key_length == length && !memcmp(g.key, key, length))
+                return &g;
+        }
+        return nullptr;
+    }
+
+    void add(uint64 hash, const char *key, size_t length, uint64 tsc, bool valued, long long value) {
+        Aggregate_group *g = find(hash, key, length);
+        if(!g) {
+            missed++;
+            return;
+        }
+        g->count++;
+        g->tsc_min = min(g->tsc_min, tsc);
+        g->tsc_max = max(g->tsc_max, tsc);
+        if(!valued)
+            return;
+        g->value_min = g->count_values ? min(g->value_min, value) : value;
+        g->value_max = g->count_values ? max(g->value_max, value) : value;
+        g->count_values++;
+    }
+
+    void merge(Aggregate_group const &o) {
+        Aggregate_group *g = find(o.hash, o.key, o.key_length);
+        if(!g) {
+            missed += o.count;
+            return;
+        }
+        g->count += o.count;
+        g->tsc_min = min(g->tsc_min, o.tsc_min);
+        g->tsc_max = max(g->tsc_max, o.tsc_max);
+        if(!o.count_values)
+            return;
+        g->value_min = g->count_values ? min(g->value_min, o.value_min) : o.value_min;
+        g->value_max = g->count_values ? max(g->value_max, o.value_max) : o.value_max;
+        g->count_values += o.count_values;
+    }
+};
+
+/**
+ * Finds the k-th token of the n bytes of s
+ * @param s
+ * @param n
+ * @param k
+ * @param t : its start
+ * @param length : its length
+ * @return false if there is none
+ */
+static bool token(const char *s, size_t n, size_t k, const char *&t, size_t &length) {
+    const char *end = s + n;
+    while(true) {
+        while(s < end && !Zone::is_token(*s))
+            s++;
+        if(s == end)
+            return false;
+        t = s;
+        while(s < end && Zone::is_token(*s))
+            s++;
+        if(!k--) {
+            length = static_cast<size_t>(s - t);
+            return true;
+        }
+    }
+}
+
+/**
+ * Reads a decimal, or 0x prefixed hexadecimal, number
+ * @param s
+ * @param n
+ * @param value
+ * @return false if the n bytes of s are not a number
+ */
+static bool number(const char *s, size_t n, long long &value) {
+    unsigned base = n > 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X') ? 16 : 10;
+    unsigned long long v = 0;
+    for(size_t i = base == 16 ? 2 : 0; i < n; i++) {
+        char c = s[i];
+        unsigned d = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 :
+                c >= 'A' && c <= 'F' ? c - 'A' + 10 : 16;
+        if(d >= base)
+            return false;
+        v = v * base + d;
+    }
+    value = static_cast<long long>(v);
+    return true;
+}
+
+/**
+ * Accounts for the text s, of n bytes, in t, if it holds the key of the query
+ * @param q
+ * @param t
+ * @param s
+ * @param n
+ * @param tsc
+ */
+static void account(Aggregate_query const &q, Group_table &t, const char *s, size_t n, uint64 tsc) {
+    if(q.prefix) {
+        size_t m = strlen(q.prefix);
+        const char *p = Search::scan(s, n, q.prefix, m);
+        if(!p)
+            return;
+        n -= static_cast<size_t>(p + m - s);
+        s = p + m;
+    }
+    const char *key, *v;
+    size_t length, vl;
+    if(!token(s, n, q.field, key, length))
+        return;
+    uint64 hash = 0xcbf29ce484222325ull;
+    for(size_t i = 0; i < length; i++)
+        hash = (hash ^ static_cast<uint8>(key[i])) * 0x100000001b3ull;
+    long long value = 0;
+    bool valued = q.value != Aggregate_query::NONE &&
+            token(key + length, static_cast<size_t>(s + n - key - length), q.value, v, vl) &&
+            number(v, vl, value);
+    t.add(hash, key, length, tsc, valued, value);
+}
+
+/**
+ * @param q
+ * @param t
+ * @return the visitor of the logs, which accounts for their titles or entries in t
+ */
+static auto visitor(Aggregate_query const &q, Group_table &t) {
+    return [&q, &t](Log_view const &l) {
+        if(!q.entries) {
+            account(q, t, l.title, l.title_length, l.tsc);
+            return;
+        }
+        Log_walk::entries(l, [&](Entry_view const &e) {
+            account(q, t, e.text, e.length, l.tsc + e.tsc_delta);
+        });
+    };
+}
+
+struct Segment {
+    Aggregate_query const *query;
+    size_t from, to;        // store log indexes
+    Aggregate_group *groups;
+    size_t max, missed;
+    pthread_t thread;
+    bool started;
+};
+
+static void* run_segment(void *p) {
+    Segment *s = reinterpret_cast<Segment*>(p);
+    Group_table t(s->groups, s->max);
+    Log_walk::store_logs(s->from, s->to, visitor(*s->query, t));
+    s->missed = t.missed;
+    return nullptr;
+}
+
+static int by_count(const void *a, const void *b) {
+    size_t x = reinterpret_cast<const Aggregate_group*>(a)->count,
+            y = reinterpret_cast<const Aggregate_group*>(b)->count;
+    return x > y ? -1 : x < y;
+}
+
+/**
+ * Groups the logs, or their entries, by the key of the query, in one pass.
+ * Cold and queue logs are aggregated by the calling thread; the store logs
+ * are split in q.threads segments, each aggregated by a thread of its own in
+ * a table of max groups, and merged. Producers are held off meanwhile, if the
+ * Reclaimer thread is running; otherwise they must not log concurrently.
+ * @param q
+ * @param groups : filled with up to max groups, the most counted first
+ * @param max
+ * @param missed : the texts whose key found no room among the groups
+ * @return the number of groups
+ */
+size_t Aggregate::group(Aggregate_query const &q, Aggregate_group *groups, size_t max, size_t &missed) {
+    Reclaimer::Guard guard;
+    missed = 0;
+    if(!max)
+        return 0;
+    Group_table table(groups, max);
+    auto visit = visitor(q, table);
+    size_t front = Cold::get_number() + Log::get_number(), start = Log_walk::store_start(),
+            cursor = Log_walk::store_cursor(), total = front + cursor - start,
+            skip = q.last < total ? total - q.last : 0, k = 0;
+    auto skipped = [&](Log_view const &l) {
+        if(k++ >= skip)
+            visit(l);
+    };
+    Log_walk::cold_logs(skipped);
+    Log_walk::queue_logs(skipped);
+    start += skip > front ? skip - front : 0;
+    unsigned threads = q.threads > 1 ? min(q.threads, 64u) : 1;
+    if(threads == 1 || cursor - start < 2 * threads) {
+        Log_walk::store_logs(start, cursor, visit);
+    } else {
+        Segment segments[64];
+        size_t length = (cursor - start + threads - 1) / threads;
+        for(unsigned i = 0; i < threads; i++) {
+            Segment &s = segments[i];
+            s = {&q, min(start + i * length, cursor), min(start + (i + 1) * length, cursor), nullptr,
+                    max, 0, 0, false};
+            // the first segment is the calling thread's
+            if(i && (s.groups = reinterpret_cast<Aggregate_group*>(malloc(max * sizeof(Aggregate_group)))))
+                s.started = !pthread_create(&s.thread, nullptr, run_segment, &s);
+        }
+        // once all workers run : the first segment, and those no thread could be started for
+        for(unsigned i = 0; i < threads; i++)
+            if(!segments[i].started)
+                Log_walk::store_logs(segments[i].from, segments[i].to, visit);
+        for(unsigned i = 1; i < threads; i++) {
+            Segment &s = segments[i];
+            if(s.started) {
+                pthread_join(s.thread, nullptr);
+                for(size_t j = 0; j < max; j++)
+                    if(s.groups[j].count)
+                        table.merge(s.groups[j]);
+                table.missed += s.missed;
+            }
+            free(s.groups);
+        }
+    }
+    size_t used = 0;
+    for(size_t i = 0; i < max; i++)
+        if(groups[i].count)
+            groups[used++] = groups[i];
+    qsort(groups, used, sizeof(Aggregate_group), by_count);
+    missed = table.missed;
+    return used;
+}
+
+size_t Aggregate::group(Aggregate_query const &q, Aggregate_group *groups, size_t max) {
+    size_t missed;
+    return group(q, groups, max, missed);
+}
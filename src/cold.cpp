@@ -0,0 +1,221 @@
+/*
+ * File:   cold.cpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Cold : packing of the aging queue logs into a byte ring
+ *
+ * Created on 19 octobre 2026
+ */
+
+#include "cold.hpp"
+#include "log.hpp"
+#include "reclaimer.hpp"
+#include "timer.hpp"
+#include "spill.hpp"
+#include "lz.hpp"
+
+Record_ring<LOG_COLD_BYTES, LOG_COLD_BYTES / 32> Cold::ring;
+uint64 Cold::age;
+bool Cold::compressing;
+size_t Cold::unpacked;
+
+/*
+ * Per thread buffer of LOG_COLD_BYTES / 2 bytes : the entries of a log being
+ * packed, then their compressed form; or the entries of a log being read
+ */
+struct Cold_buffer {
+    char *bytes = nullptr;
+
+    ~Cold_buffer() { free(bytes); }
+};
+
+static thread_local Cold_buffer cold_buffer;
+
+/**
+ * @return the calling thread's buffer, allocated on its first use; nullptr if
+ * it could not be
+ */
+char* Cold::buffer() {
+    if(EXPECT_FALSE(!cold_buffer.bytes))
+        cold_buffer.bytes = static_cast<char*>(malloc(LOG_COLD_BYTES / 2));
+    return cold_buffer.bytes;
+}
+
+/**
+ * @param stored : the entries of a cold log, as stored
+ * @param compressed : their stored length if compressed, 0 otherwise
+ * @param bytes : their length
+ * @return the entries, decompressed if need be into the calling thread's
+ * buffer, where they stay until its next call; nullptr if they are corrupted
+ */
+const char* Cold::unpack(const char *stored, size_t compressed, size_t bytes) {
+    if(!compressed)
+        return stored;
+    char *b = buffer();
+    if(!b || Lz::decompress(stored, compressed, b, LOG_COLD_BYTES / 4) != bytes)
+        return nullptr;
+    return b;
+}
+
+/**
+ * Packs the log l into a single record, dropping the oldest cold logs until
+ * it fits; its entries are compressed if set_compression() was called and it
+ * makes them shorter. Logs bigger than a quarter of the ring are not kept.
+ * @param l
+ * @return false if l could not be packed
+ */
+bool Cold::pack(Log *l) {
+    size_t title_length = l->info->get_length(), bytes = 0;
+    for(size_t k = 0; k < l->log_size; k++)
+        bytes += sizeof(Cold_entry) + l->entry_index[k]->log_entry->get_length();
+    size_t n = sizeof(Cold_log) + title_length + bytes;
+    if(n > LOG_COLD_BYTES / 4)
+        return false;
+    auto entries = [&](char *p) {
+        for(size_t k = 0; k < l->log_size; k++) {
+            Log_entry *e = l->entry_index[k];
+            Cold_entry ce = {e->tsc_delta, static_cast<uint32>(e->log_entry->get_length()), 0};
+            memcpy(p, &ce, sizeof(ce));
+            memcpy(p += sizeof(ce), e->log_entry->get_string(), ce.length);
+            p += ce.length;
+        }
+    };
+    char *b = compressing && bytes ? buffer() : nullptr, *compressed = nullptr;
+    size_t c = 0;
+    if(b) {
+        entries(b);
+        compressed = b + LOG_COLD_BYTES / 4;
+        c = Lz::compress(b, bytes, compressed, bytes - 1);
+    }
+    auto fill = [&](char *p) {
+        Cold_log cl = {l->tsc, static_cast<uint32>(title_length), static_cast<uint32>(l->log_size),
+                static_cast<uint32>(bytes), static_cast<uint32>(c)};
+        memcpy(p, &cl, sizeof(cl));
+        memcpy(p += sizeof(cl), l->info->get_string(), title_length);
+        p += title_length;
+        if(c)
+            memcpy(p, compressed, c);
+        else
+            entries(p);
+    };
+    if(c)
+        n -= bytes - c;
+    while(!~ring.add_with(n, 0, fill)) {
+        if(!ring.size())
+            return false;
+        if(Spill::on())
+            spill(*ring.at(ring.first_number()));
+        ring.free(1);
+    }
+    l->packed = true;
+    return true;
+}
+
+/**
+ * Hands the cold log r over to the Spill, before it is dropped
+ * @param r
+ */
+void Cold::spill(Record const &r) {
+    Cold_log c;
+    Cold_entry e;
+    const char *p = r.text();
+    memcpy(&c, p, sizeof(c));
+    p += sizeof(c);
+    Spill::record(JOURNAL_LOG, c.tsc, p, c.title_length);
+    p = unpack(p + c.title_length, c.compressed, c.bytes);
+    for(uint32 k = 0; p && k < c.entries; k++) {
+        memcpy(&e, p, sizeof(e));
+        p += sizeof(e);
+        Spill::record(JOURNAL_ENTRY, c.tsc + e.tsc_delta, p, e.length);
+        p += e.length;
+    }
+    Spill::commit();
+}
+
+/**
+ * Queue logs older than us microseconds are packed by migrate(); 0 disables
+ * the cold tier, which leaves the cold logs already packed in place
+ * @param us
+ */
+void Cold::set_age(uint64 us) {
+    age = us ? max(Timer::us_to_tsc(us), 1ull) : 0;
+}
+
+/**
+ * Packs the queue logs older than the age into the cold ring, and frees them.
+ * The newest queue log is always kept, as it may still be written to. A log
+ * too big to be packed stops the migration : it stays in the queue, with the
+ * logs after it, until eviction is due. Run by the Reclaimer thread; may be
+ * called directly when it is not running.
+ */
+void Cold::migrate() {
+    Reclaimer::Guard guard;
+    size_t qn = Log::get_number(), q = 0;
+    if(!age || qn <= 1)
+        return;
+    uint64 now = Timer::now();
+    Log *l = Log::logs.head();
+    while(q + 1 < qn && now - l->tsc > age && pack(l)) {
+        l = l->next;
+        q++;
+    }
+    if(q)
+        Log::free_logs(qn - q, false);
+}
+
+/**
+ * Evicts the n oldest queue logs, packing them first when the cold tier is
+ * enabled. The newest queue log is always kept. Logs too big to be packed are
+ * destroyed all the same, being due for eviction, and counted; the Spill gets
+ * them, when it is on
+ * @param n
+ */
+void Cold::evict(size_t n) {
+    Reclaimer::Guard guard;
+    size_t qn = Log::get_number();
+    if(n >= qn)
+        n = qn - 1;
+    if(!n)
+        return;
+    if(age) {
+        Log *l = Log::logs.head();
+        for(size_t k = 0; k < n; k++, l = l->next)
+            if(!pack(l))
+                unpacked++;
+    }
+    Log::free_logs(qn - n, false);
+}
+
+/**
+ * Prints every cold log, from the oldest
+ * @param funct_name : Where we come from
+ * @param sink : where to write the logs to; default is the standard output
+ */
+void Cold::dump(char const *funct_name, Sink &sink) {
+    Reclaimer::Guard guard;
+    size_t numero = 0;
+    sink.format("%s Cold %lu logs\n", funct_name, ring.size());
+    if(unpacked)
+        sink.format("Unpacked %lu logs, too big for the cold tier\n", unpacked);
+    ring.walk(ring.first_number(), ring.size(), [&](Record const &r) {
+        Cold_log c;
+        Cold_entry e;
+        const char *p = r.text();
+        memcpy(&c, p, sizeof(c));
+        p += sizeof(c);
+        sink.format("LOG %lu size %u tsc %llu ", numero++, c.entries, c.tsc);
+        sink.put(p, c.title_length);
+        sink.put("\n", 1);
+        p = unpack(p + c.title_length, c.compressed, c.bytes);
+        for(uint32 k = 0; p && k < c.entries; k++) {
+            memcpy(&e, p, sizeof(e));
+            p += sizeof(e);
+            sink.format("tsc %llu ", c.tsc + e.tsc_delta);
+            sink.put(p, e.length);
+            sink.put("\n", 1);
+            p += e.length;
+        }
+        if(c.compressed)    // the sink references the entries, which the next log's overwrite
+            sink.flush();
+    });
+    sink.flush();
+}
@@ -0,0 +1,185 @@
+/*
+ * File:   eviction.cpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Eviction : high/low watermark eviction of the oldest logs
+ *
+ * Created on 19 octobre 2026
+ */
+
+#include "eviction.hpp"
+#include "log.hpp"
+#include "log_store.hpp"
+#include "cold.hpp"
+#include <cassert>
+
+Eviction::Watermark Eviction::high = {HEAP_HIGH_WATERMARK, LOG_HIGH_WATERMARK, LOG_ENTRY_HIGH_WATERMARK},
+        Eviction::low = {HEAP_LOW_WATERMARK, LOG_LOW_WATERMARK, LOG_ENTRY_LOW_WATERMARK},
+        Eviction::hard = {(HEAP_HIGH_WATERMARK + 100)/2, LOG_MAX - 1, LOG_ENTRY_MAX - 1};
+
+/**
+ * Is any of the heap usage, log count or entry count above the watermark w
+ * @param w
+ * @return
+ */
+bool Eviction::above(Watermark const &w) {
+    size_t heap_size = Block::heap_size();
+    return (heap_size - Block::free_bytes()) * 100 > w.heap * heap_size ||
+            Log::get_number() > w.logs || Logstore::get_number() > w.logs ||
+            Log_entry::get_total_log_size() > w.entries ||
+            Logstore::get_entry_number() > w.entries;
+}
+
+/**
+ * Number of oldest logs to be evicted, out of n logs holding entries entries,
+ * to bring them under the low watermark. Logs are assumed to hold the same
+ * number of entries and heap bytes on average, so that it is done in one
+ * free_logs() call most of the time; at least LOG_EVICTION_SLICE logs are
+ * evicted, and the newest log is always kept
+ * @param n
+ * @param entries
+ * @param heap_excess : the heap bytes in use above the low watermark
+ * @param heap_used
+ * @param low_logs
+ * @param low_entries
+ * @return
+ */
+static size_t excess(size_t n, size_t entries, size_t heap_excess, size_t heap_used,
+        size_t low_logs, size_t low_entries) {
+    if(n <= 1)
+        return 0;
+    size_t e = n > low_logs ? n - low_logs : 0;
+    if(entries > low_entries)
+        e = max(e, (entries - low_entries) * n / entries + 1);
+    if(heap_excess)
+        e = max(e, heap_excess * n / heap_used + 1);
+    if(!e)
+        return 0;
+    return min(max(e, static_cast<size_t>(LOG_EVICTION_SLICE)), n - 1);
+}
+
+/**
+ * Evicts the oldest logs, from Log and from Logstore, towards the low watermark,
+ * but at most slice logs from each. Logstore logs take no heap bytes, they are
+ * only evicted for their count. Log logs go to the Cold tier when it is enabled
+ * @param slice
+ * @return false if everything was already under the low watermark (or a single
+ * log was left)
+ */
+bool Eviction::evict_slice(size_t slice) {
+    size_t heap_size = Block::heap_size(), heap_used = heap_size - Block::free_bytes(),
+            heap_low = low.heap * heap_size / 100, heap_excess = heap_used > heap_low ? heap_used - heap_low : 0,
+            q = excess(Log::get_number(), Log_entry::get_total_log_size(), heap_excess,
+                    heap_used, low.logs, low.entries),
+            s = excess(Logstore::get_number(), Logstore::get_entry_number(), 0, heap_used, 
+                    low.logs, low.entries);
+    if(!q && !s)
+        return false;
+    if(q)
+        Cold::evict(min(q, slice));
+    if(s)
+        Logstore::free_logs(Logstore::get_number() - min(s, slice), false);
+    return true;
+}
+
+/**
+ * Evicts the oldest logs until everything is back under the low watermark (or
+ * a single log is left)
+ */
+void Eviction::evict_to_low() {
+    while(evict_slice());
+}
+
+/**
+ * Evicts the oldest Log logs until their heap bytes add up to bytes; Logstore
+ * logs live outside of the heap. The newest log is always kept
+ * @param bytes
+ * @return the number of evicted logs
+ */
+size_t Eviction::evict_oldest(size_t bytes) {
+    size_t qn = Log::get_number(), q = 0, freed = 0;
+    Log *ql = Log::logs.head();
+    while(freed < bytes && q + 1 < qn) {
+        freed += ql->bytes;
+        ql = ql->next;
+        q++;
+    }
+    if(q)
+        Cold::evict(q);
+    return q;
+}
+
+/**
+ * Evicts enough of the oldest logs for bytes to be available in the heap, using
+ * the logs' heap bytes accounting, and goes on down to the heap low watermark,
+ * so that the next allocations do not run out of heap right away. If contiguous,
+ * the bytes have to be available in a single free block : logs are allocated in
+ * creation order, so evicting further old logs usually merges free blocks; this
+ * is tried for as much as bytes again before giving up, the caller may then
+ * defragment.
+ * @param bytes
+ * @param contiguous
+ * @return true if the bytes are available
+ */
+bool Eviction::evict_bytes(size_t bytes, bool contiguous) {
+    size_t heap_size = Block::heap_size(), free = Block::free_bytes(),
+            target = max(bytes, heap_size - low.heap * heap_size / 100);
+    if(free < target)
+        evict_oldest(target - free);
+    if(!contiguous)
+        return Block::free_bytes() >= bytes;
+    if(Block::largest() < bytes)
+        evict_oldest(bytes);
+    return Block::largest() >= bytes;
+}
+
+/**
+ * @param high_percent : percentage of the heap in use which triggers eviction
+ * @param low_percent : percentage of the heap in use eviction stops at
+ */
+void Eviction::set_heap_watermarks(size_t high_percent, size_t low_percent) {
+    assert(low_percent <= high_percent && high_percent <= 100);
+    high.heap = high_percent;
+    low.heap = low_percent;
+    hard.heap = (high_percent + 100)/2;
+}
+
+/**
+ * @param h : log count which triggers eviction
+ * @param l : log count eviction stops at
+ */
+void Eviction::set_log_watermarks(size_t h, size_t l) {
+    assert(l <= h && h <= hard.logs);
+    high.logs = h;
+    low.logs = l;
+}
+
+/**
+ * @param h : log entry count which triggers eviction
+ * @param l : log entry count eviction stops at
+ */
+void Eviction::set_entry_watermarks(size_t h, size_t l) {
+    assert(l <= h && h <= hard.entries);
+    high.entries = h;
+    low.entries = l;
+}
+
+/**
+ * Derives the log and entry watermarks from the capacities of the Logstore, once
+ * it is sized at run time : the hard limits are just under them, and high and
+ * low watermarks above them are scaled down, keeping their ratio to the storage
+ * reserved (by default 90% and 75% of the capacities)
+ * @param logs : the logs the Logstore holds
+ * @param entries : the entries it holds
+ */
+void Eviction::fit(size_t logs, size_t entries) {
+    auto scale = [](size_t &h, size_t &l, size_t to, size_t from) {
+        if(h < to)
+            return;
+        h = h * to / from;
+        l = l * to / from;
+    };
+    scale(high.logs, low.logs, logs, LOG_MAX);
+    scale(high.entries, low.entries, entries, LOG_ENTRY_MAX);
+    hard.logs = logs - 1;
+    hard.entries = entries - 1;
+}
@@ -0,0 +1,136 @@
+/*
+ * File:   journal.cpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Journal : crash-persistent, file-backed record ring
+ *
+ * Created on 19 octobre 2026
+ */
+
+#include "journal.hpp"
+#include "string.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+Journal_header *Journal::header;
+char *Journal::ring;
+size_t Journal::mapped;
+
+/**
+ * Maps the journal file path. An existing, valid journal is reopened and
+ * appended to, whatever its size; otherwise the file is (re)initialized with
+ * a ring of 2^order bytes.
+ * @param path
+ * @param order
+ * @return false if the file could not be mapped
+ */
+bool Journal::open(char const *path, unsigned order) {
+    if(header)
+        return true;
+    int fd = ::open(path, O_RDWR | O_CREAT, 0644);
+    if(fd < 0)
+        return false;
+    Journal_header h;
+    bool valid = pread(fd, &h, sizeof(h), 0) == sizeof(h) && h.magic == JOURNAL_MAGIC &&
+            h.version == JOURNAL_VERSION && h.header_size == sizeof(h) && h.size &&
+            !(h.size & (h.size - 1)) && h.head - h.tail <= h.size;
+    uint64 size = valid ? h.size : 1ull << order;
+    size_t total = sizeof(Journal_header) + size;
+    struct stat st;
+    if(fstat(fd, &st) || (static_cast<size_t>(st.st_size) != total && ftruncate(fd, total))) {
+        ::close(fd);
+        return false;
+    }
+    void *m = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(m == MAP_FAILED)
+        return false;
+    Journal_header *jh = reinterpret_cast<Journal_header*>(m);
+    if(!valid) {
+        memset(jh, 0, sizeof(Journal_header));
+        jh->version = JOURNAL_VERSION;
+        jh->header_size = sizeof(Journal_header);
+        jh->size = size;
+        __atomic_store_n(&jh->magic, JOURNAL_MAGIC, __ATOMIC_RELEASE);
+    }
+    ring = reinterpret_cast<char*>(jh + 1);
+    mapped = total;
+    header = jh;
+    return true;
+}
+
+/**
+ * Appends a record to the ring of h and commits it. Records too big for the
+ * ring are truncated to a quarter of it. The oldest records are dropped (tail
+ * is advanced and published) before their bytes are overwritten.
+ * @param h
+ * @param ring : the h->size bytes following h
+ * @param type
+ * @param tsc
+ * @param s : the payload
+ * @param length
+ * @param fenced : whether readers may be reading the dropped records meanwhile;
+ * the tail is then fenced off the writes which overwrite them
+ */
+void Journal::append(Journal_header *h, char *ring, uint32 type, uint64 tsc, const char* s, size_t length,
+        bool fenced) {
+    uint64 size = h->size, mask = size - 1;
+    if(length > size/4 - sizeof(Journal_record))
+        length = size/4 - sizeof(Journal_record);
+    uint64 need = journal_record_size(static_cast<uint32>(length)), head = h->head,
+            pos = head & mask, pad = pos + need > size ? size - pos : 0, tail = h->tail;
+    while(head + pad + need - tail > size)
+        tail += journal_record_size(reinterpret_cast<Journal_record*>(ring + (tail & mask))->length);
+    if(tail != h->tail) {
+        if(fenced) {
+            __atomic_store_n(&h->tail, tail, __ATOMIC_RELAXED);
+            __atomic_thread_fence(__ATOMIC_RELEASE);
+        } else
+            __atomic_store_n(&h->tail, tail, __ATOMIC_RELEASE);
+    }
+    if(pad) {
+        Journal_record *p = reinterpret_cast<Journal_record*>(ring + pos);
+        p->length = static_cast<uint32>(pad - sizeof(Journal_record));
+        p->type = JOURNAL_PAD;
+        p->tsc = tsc;
+        pos = 0;
+    }
+    Journal_record *r = reinterpret_cast<Journal_record*>(ring + pos);
+    r->length = static_cast<uint32>(length);
+    r->type = type;
+    r->tsc = tsc;
+    if(length)
+        memcpy(r + 1, s, length);
+    __atomic_store_n(&h->head, head + pad + need, __ATOMIC_RELEASE);
+}
+
+/**
+ * Appends a record to the journal and commits it
+ * @param type
+ * @param tsc
+ * @param s : the payload
+ * @param length
+ */
+void Journal::write(uint32 type, uint64 tsc, const char* s, size_t length) {
+    append(header, ring, type, tsc, s, length, false);
+}
+
+/**
+ * Forces the journal to the disk, so that it also survives a system crash
+ */
+void Journal::sync() {
+    if(header)
+        msync(header, mapped, MS_SYNC);
+}
+
+/**
+ * Unmaps the journal; records are not written anymore
+ */
+void Journal::close() {
+    if(!header)
+        return;
+    Journal_header *h = header;
+    header = nullptr;
+    munmap(h, mapped);
+}
@@ -0,0 +1,84 @@
+/*
+ * File:   live.cpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Live : shared memory record ring, tailed by other processes
+ *
+ * Created on 19 octobre 2026
+ */
+
+#include "live.hpp"
+#include "journal.hpp"
+#include "string.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+Journal_header *Live::header;
+char *Live::ring;
+size_t Live::mapped;
+char Live::name[256];
+
+/**
+ * Creates the shared memory object n, holding a ring of 2^order bytes. An
+ * object left over by a previous run is unlinked first : its readers keep
+ * their mapping of it, and have to open the new one.
+ * @param n : "/name", as for shm_open
+ * @param order
+ * @return false if the object could not be created or mapped
+ */
+bool Live::open(char const *n, unsigned order) {
+    if(header)
+        return true;
+    if(strlen(n) >= sizeof(name) || order < 8 || order > 40)
+        return false;
+    shm_unlink(n);
+    int fd = shm_open(n, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if(fd < 0)
+        return false;
+    uint64 size = 1ull << order;
+    size_t total = sizeof(Journal_header) + size;
+    void *m = ftruncate(fd, total) ? MAP_FAILED :
+            mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(m == MAP_FAILED) {
+        shm_unlink(n);
+        return false;
+    }
+    Journal_header *h = reinterpret_cast<Journal_header*>(m);    // zeroed by ftruncate
+    h->version = JOURNAL_VERSION;
+    h->header_size = sizeof(Journal_header);
+    h->size = size;
+    __atomic_store_n(&h->magic, LIVE_MAGIC, __ATOMIC_RELEASE);
+    memcpy(name, n, strlen(n) + 1);
+    ring = reinterpret_cast<char*>(h + 1);
+    mapped = total;
+    header = h;
+    return true;
+}
+
+/**
+ * Appends a record and commits it. Readers may be reading the oldest records :
+ * tail is published past them, and fenced, before their bytes are overwritten,
+ * so that readers can tell.
+ * @param type
+ * @param tsc
+ * @param s : the payload
+ * @param length
+ */
+void Live::write(uint32 type, uint64 tsc, const char* s, size_t length) {
+    Journal::append(header, ring, type, tsc, s, length, true);
+}
+
+/**
+ * Unmaps and unlinks the ring; records are not written anymore. Readers keep
+ * what they have mapped.
+ */
+void Live::close() {
+    if(!header)
+        return;
+    Journal_header *h = header;
+    header = nullptr;
+    munmap(h, mapped);
+    shm_unlink(name);
+}
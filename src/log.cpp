@@ -15,34 +15,36 @@
 #include "log.hpp"
 #include "string.hpp"
 #include "log_store.hpp"
+#include "reclaimer.hpp"
+#include "eviction.hpp"
+#include "journal.hpp"
+#include "live.hpp"
+#include "spill.hpp"
+#include "render.hpp"
+#include "trace.hpp"
+#include "cold.hpp"
 
-size_t Log::log_number = 0, Log_entry::log_entry_number = 0;
+size_t Log::log_number = 0, Log::dropped = 0, Log_entry::log_entry_number = 0;
 bool Log::log_on;
 Queue<Log> Log::logs;
-char *Log::entry_buffer = reinterpret_cast<char*>(malloc(PAGE_SIZE)), 
-        *Log::log_buffer = reinterpret_cast<char*>(malloc(PAGE_SIZE)),
-        *Log::entry_buffer_cursor = Log::entry_buffer,
-        *Log::log_buffer_cursor = Log::log_buffer;
 
 Log::Log(const char* title) : prev(nullptr), next(nullptr){
+    tsc = Timer::now();
     info = new String(title);
+    bytes = info->size();
     numero = log_number++;
 };
 
 /**
- * Add new log. If the log at cursor index does have a string, it just replaces 
- * its content, if not, it creates a new one. The creation process is supposed to 
- * be called only on time
- * @param pd_name
- * @param ec_name
+ * Add new log, at the tail of the queue
+ * @param s
+ * @param n : length of s
 */
-void Log::add_log(const char* s){
-    if(!log_on  || !strlen(s))
-        return;
-    if(log_number > LOG_MAX)
-        free_logs(LOG_PERCENT_TO_BE_LEFT, true);
+void Log::put_log(const char* s, size_t n){
     Log* log = new Log(s);
     logs.enqueue(log);
+    Journal::record(JOURNAL_LOG, log->tsc, s, n);
+    Live::record(JOURNAL_LOG, log->tsc, s, n);
 }
 
 /**
@@ -52,6 +54,7 @@ void Log::add_log(const char* s){
  * @param in_percent
  */
 void Log::free_logs(size_t left, bool in_percent) {
+    Reclaimer::Guard guard;
     if(!log_number)
         return;
     Log *log = nullptr;
@@ -65,6 +68,8 @@ void Log::free_logs(size_t left, bool in_percent) {
         left = 1; 
     
     while (left < log_number && logs.dequeue(log = logs.head())) {
+        if(Spill::on() && !log->packed)
+            log->spill();
         delete log;
     }
 
@@ -88,133 +93,179 @@ void Log::free_logs(size_t left, bool in_percent) {
  * @param from_tail : From the first log (from_tail == false) or from the last
  * @param log_depth : the number of log to be printed; default is 5; we will print
  * all logs if this is 0
+ * @param sink : where to write the logs to; default is the standard output
+ * @param threads : rendering the logs in parallel, see Render; their list is
+ * then gathered first, so that any of them is found in O(1)
  */
-void Log::dump(char const *funct_name, bool from_tail, size_t log_depth){   
+void Log::dump(char const *funct_name, bool from_tail, size_t log_depth, Sink &sink, 
+        unsigned threads){   
+    Reclaimer::Guard guard;
     if(!logs.head())
         return;
-    printf("%s Log %lu log entries %lu\n", funct_name, log_number, Log_entry::log_entry_number);
+    sink.format("%s Log %lu log entries %lu\n", funct_name, log_number, Log_entry::log_entry_number);
+    Trace_site::report(sink);
+    report(sink);
     Log *p = from_tail ? logs.tail() : logs.head(), *end = from_tail ? logs.tail() : logs.head(), 
             *n = nullptr;
     if(log_depth == 0)
         log_depth = 100000000ul;
+    Log **list = threads > 1 ? reinterpret_cast<Log**>(malloc(min(log_depth, log_number) * sizeof(Log*))) : 
+            nullptr;
+    if(list) {
+        size_t count = 0;
+        while(p && count < min(log_depth, log_number)) {
+            list[count++] = p;
+            n = from_tail ? p->prev : p->next;
+            p = (n == end) ? nullptr : n;
+        }
+        Render::run(count, threads, sink, [&](size_t k, Sink &s) { list[k]->print(s, false); });
+        free(list);
+        return;
+    }
     uint32 count = 0;
     while(p && count<log_depth) {
-        p->print(false);
+        p->print(sink, false);
         n = from_tail ? p->prev : p->next;
         p = (n == end) ? nullptr : n;
         count++;
     }
+    sink.flush();
 }
 
+/**
+ * Prints the logs created between tsc_from and tsc_to (both included). Logs are
+ * chained in creation order, so the window is found by walking back from the 
+ * newest log; recent windows are thus reached without touching older logs.
+ * @param funct_name : Where we come from
+ * @param tsc_from
+ * @param tsc_to
+ * @param sink
+ */
+void Log::dump_window(char const *funct_name, uint64 tsc_from, uint64 tsc_to, Sink &sink){
+    Reclaimer::Guard guard;
+    if(!logs.head())
+        return;
+    Log *p = logs.tail(), *first = nullptr;
+    while(p && p->tsc >= tsc_from) {
+        first = p;
+        p = (p == logs.head()) ? nullptr : p->prev;
+    }
+    sink.format("%s Log %lu log entries %lu window %llu -> %llu\n", funct_name, log_number, 
+            Log_entry::log_entry_number, tsc_from, tsc_to);
+    Trace_site::report(sink);
+    report(sink);
+    p = first;
+    while(p && p->tsc <= tsc_to) {
+        p->print(sink, false);
+        p = (p->next == logs.head()) ? nullptr : p->next;
+    }
+    sink.flush();
+}
+
+/**
+ * Writes the number of entries dropped for lack of memory, if any
+ * @param sink
+ */
+void Log::report(Sink &sink) {
+    if(dropped)
+        sink.format("Dropped %lu entries, out of memory\n", dropped);
+}
 
 /**
- * This will add a log entry with new string the first time the log at the cursor
- * is used, subsequent times it will just replace its content
- * @param log
+ * Add a log entry to the last log. Its index lives in the C heap : when it
+ * cannot grow, the oldest logs are evicted, LOG_EVICTION_SLICE at a time, to
+ * give their indexes back, and the entry is only dropped, and counted, once
+ * the last log is left alone
+ * @param s : null terminated
+ * @param n : length of s
  */
-void Log::add_log_entry(const char* log){
-    if(!log_on || !strlen(log))
-        return;    
+void Log::put_entry(const char* s, size_t n){
     Log *l = logs.tail();
     assert(l);
-    char buff[STR_MAX_LENGTH];
-    String::print(buff, "%lu %s", l->log_size, log);
-    Log_entry *log_info = new Log_entry(buff);
+    if(l->log_size == l->index_capacity) {
+        size_t capacity = l->index_capacity ? 2 * l->index_capacity : 8;
+        Log_entry **index;
+        while(!(index = reinterpret_cast<Log_entry**>(realloc(l->entry_index, capacity * sizeof(Log_entry*)))) &&
+                log_number > 1)
+            Cold::evict(LOG_EVICTION_SLICE);
+        if(!index) {
+            dropped++;
+            return;
+        }
+        l->entry_index = index;
+        l->index_capacity = capacity;
+    }
+    Log_entry *log_info = new Log_entry(s);
+    log_info->tsc_delta = Timer::delta(l->tsc);
     l->log_entries.enqueue(log_info);  
-    l->log_size++;
+    l->entry_index[l->log_size++] = log_info;
+    l->bytes += log_info->log_entry->size();
+    Journal::record(JOURNAL_ENTRY, l->tsc + log_info->tsc_delta, s, n);
+    Live::record(JOURNAL_ENTRY, l->tsc + log_info->tsc_delta, s, n);
 }
 
 /**
  * Append new string to the log info. It does this by destroying the last buffer
  * and allocating a new one, wide enough, to hold the the old and the new strings
  * @param s
+ * @param n : length of s
  */
-void Log::append_log_info(const char* s){
-    if(!log_on || !strlen(s))
-        return;    
+void Log::put_info(const char* s, size_t n){
     Log *l = logs.tail();
     assert(l);
+    l->bytes -= l->info->size();
     l->info->append(s);
+    l->bytes += l->info->size();
+    Journal::record(JOURNAL_APPEND, Timer::now(), s, n);
+    Live::record(JOURNAL_APPEND, Timer::now(), s, n);
 }
 
 /**
- * Prints this log's entries, if queue were used, print from log_entries, else,
- * logstore was used, print from logstore, 
- * @param from_tail
+ * Hands this log's title and entries over to the Spill, before it is freed
  */
-void Log::print(bool from_tail){
-    printf("LOG %lu size %lu %s\n", numero, log_size, info->get_string());
-    if(log_number) {
-        Log_entry *log_info = from_tail ? log_entries.tail() : log_entries.head(), *end = from_tail ? 
-            log_entries.tail() : log_entries.head(), 
-            *n = nullptr;
-        while(log_info) {
-            log_info->print();
-            n = from_tail ? log_info->prev : log_info->next;
-            log_info = (n == end) ? nullptr : n;
-        }
-    } else {            
-        Logentrystore::dump(from_tail, start_in_store, log_size);
+void Log::spill() {
+    Spill::record(JOURNAL_LOG, tsc, info->get_string(), info->get_length());
+    for(size_t k = 0; k < log_size; k++) {
+        String *e = entry_index[k]->log_entry;
+        Spill::record(JOURNAL_ENTRY, tsc + entry_index[k]->tsc_delta, e->get_string(), e->get_length());
     }
+    Spill::commit();
 }
 
 /**
- * Add a log entry. This constructor is to be used only for queue logentries. 
- * @param l
+ * Prints this log and its entries to the standard output, and flushes it
+ * @param from_tail
  */
-Log_entry::Log_entry(char* l) {
-    if(log_entry_number > LOG_ENTRY_MAX)
-        Log::free_logs(LOG_PERCENT_TO_BE_LEFT, true);
-    log_entry = new String(l);
-    log_entry_number++;
+void Log::print(bool from_tail){
+    print(Sink::out(), from_tail);
+    Sink::out().flush();
 }
 
 /**
- * store new log to the logs'buffer
- * @param s
+ * Gathers this log and its entries into sink, which has to be flushed by the caller
+ * @param sink
+ * @param from_tail
  */
-void Log::add_log_in_buffer(const char* s){
-    if(!Log::log_on || !strlen(s))
-        return;    
-    size_t size = strlen(s); 
-    copy_string(Log::log_buffer_cursor, s);    
-    *(Log::log_buffer_cursor + size) = ' '; // replace the final '\0' by ' '
-    Log::log_buffer_cursor += size + 1; 
+void Log::print(Sink &sink, bool from_tail){
+    sink.format("LOG %lu size %lu tsc %llu ", numero, log_size, tsc);
+    sink.put(info->get_string(), info->get_length());
+    sink.put("\n", 1);
+    Log_entry *log_info = from_tail ? log_entries.tail() : log_entries.head(), *end = from_tail ? 
+        log_entries.tail() : log_entries.head(), 
+        *n = nullptr;
+    while(log_info) {
+        log_info->print(sink, tsc);
+        n = from_tail ? log_info->prev : log_info->next;
+        log_info = (n == end) ? nullptr : n;
+    }
 }
 
 /**
- * store new log entry to the entries'buffer
- * @param s
+ * Add a log entry. This constructor is to be used only for queue logentries. 
+ * @param l
  */
-void Log::add_entry_in_buffer(const char* s){
-    if(!Log::log_on || !strlen(s))
-        return;    
-    size_t size = strlen(s)+1; // +1 for the final \n
-    copy_string_nl(Log::entry_buffer_cursor, s, size);    
-    Log::entry_buffer_cursor += size; 
+Log_entry::Log_entry(const char* l) {
+    Eviction::check();
+    log_entry = new String(l);
+    log_entry_number++;
 }
-
-/**
- * Commit log buffer and entries buffer
- */
-void Log::commit_buffer(){
-    if(!Log::log_on)
-        return;    
-    if(!strlen(Log::log_buffer))
-        return;
-    *Log::log_buffer_cursor = '\0';
-    add_log(Log::log_buffer);
-    memset(Log::log_buffer, 0, Log::log_buffer_cursor - Log::log_buffer + 1);
-    Log::log_buffer_cursor = Log::log_buffer;
-    
-    if(!strlen(Log::entry_buffer))
-        return;
-    *Log::entry_buffer_cursor = '\0';
-    Log* l = logs.tail();
-    assert(l);
-    Log_entry *log_info = new Log_entry(Log::entry_buffer);
-    l->log_entries.enqueue(log_info);  
-    l->log_size++;
-    memset(Log::entry_buffer, 0, Log::entry_buffer_cursor - Log::entry_buffer + 1);
-    Log::entry_buffer_cursor = Log::entry_buffer;
-}
\ No newline at end of file
@@ -0,0 +1,154 @@
+/*
+ * File:   lz.cpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Lz : LZ77 compression of the cold logs
+ *
+ * Created on 19 octobre 2026
+ */
+
+#include "lz.hpp"
+#include "string.hpp"
+
+ALWAYS_INLINE
+static inline uint32 read32(const char *p) {
+    uint32 v;
+    __builtin_memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/**
+ * Writes a count above 15 as 255 bytes and a last byte below 255
+ * @param n : the count, minus 15
+ * @param o : where to write it
+ * @param end : of the output
+ * @return past the count, nullptr if it does not fit
+ */
+static char* put_count(size_t n, char *o, char *end) {
+    for(; n >= 255; n -= 255) {
+        if(o == end)
+            return nullptr;
+        *o++ = static_cast<char>(255);
+    }
+    if(o == end)
+        return nullptr;
+    *o++ = static_cast<char>(n);
+    return o;
+}
+
+/**
+ * Reads a count written by put_count
+ * @param n : the count, 15 on input
+ * @param i : where to read it, moved past it
+ * @param end : of the input
+ * @return false if the input ends first
+ */
+static bool get_count(size_t &n, const char *&i, const char *end) {
+    uint8 b;
+    do {
+        if(i == end)
+            return false;
+        b = static_cast<uint8>(*i++);
+        n += b;
+    } while(b == 255);
+    return true;
+}
+
+/**
+ * Writes a sequence : the literals [l, l + literals), then a match of length
+ * bytes at offset, unless length is 0
+ * @return past the sequence, nullptr if it does not fit
+ */
+static char* put_sequence(const char *l, size_t literals, size_t offset, size_t length,
+        char *o, char *end) {
+    size_t m = length ? length - 4 : 0;
+    if(o == end)
+        return nullptr;
+    char *token = o++;
+    *token = static_cast<char>((literals < 15 ? literals : 15) << 4 | (m < 15 ? m : 15));
+    if(literals >= 15 && !(o = put_count(literals - 15, o, end)))
+        return nullptr;
+    if(static_cast<size_t>(end - o) < literals)
+        return nullptr;
+    memcpy(o, l, literals);
+    o += literals;
+    if(!length)
+        return o;
+    if(end - o < 2)
+        return nullptr;
+    *o++ = static_cast<char>(offset & 0xff);
+    *o++ = static_cast<char>(offset >> 8);
+    if(m >= 15 && !(o = put_count(m - 15, o, end)))
+        return nullptr;
+    return o;
+}
+
+/**
+ * Compresses the n bytes of s into out
+ * @param s
+ * @param n
+ * @param out
+ * @param max : bytes of out
+ * @return the compressed length, 0 if it would be more than max
+ */
+size_t Lz::compress(const char *s, size_t n, char *out, size_t max) {
+    uint32 table[1 << HASH_BITS] = {};      // position + 1 of the last occurrence of a prefix
+    char *o = out, *end = out + max;
+    size_t i = 0, anchor = 0;
+    while(i + MATCH_MIN <= n) {
+        uint32 h = (read32(s + i) * 2654435761u) >> (32 - HASH_BITS);
+        size_t ref = table[h];
+        table[h] = static_cast<uint32>(i + 1);
+        if(!ref-- || i - ref > OFFSET_MAX || read32(s + ref) != read32(s + i)) {
+            i++;
+            continue;
+        }
+        size_t length = MATCH_MIN;
+        while(i + length < n && s[ref + length] == s[i + length])
+            length++;
+        if(!(o = put_sequence(s + anchor, i - anchor, i - ref, length, o, end)))
+            return 0;
+        i += length;
+        anchor = i;
+    }
+    if(!(o = put_sequence(s + anchor, n - anchor, 0, 0, o, end)))
+        return 0;
+    return o - out;
+}
+
+/**
+ * Decompresses the n bytes of s, as written by compress(), into out
+ * @param s
+ * @param n
+ * @param out
+ * @param max : bytes of out
+ * @return the decompressed length, ~0ul if s is malformed or out too small
+ */
+size_t Lz::decompress(const char *s, size_t n, char *out, size_t max) {
+    const char *i = s, *end = s + n;
+    size_t o = 0;
+    while(i < end) {
+        uint8 token = static_cast<uint8>(*i++);
+        size_t literals = token >> 4, length = token & 15;
+        if(literals == 15 && !get_count(literals, i, end))
+            return ~0ul;
+        if(static_cast<size_t>(end - i) < literals || max - o < literals)
+            return ~0ul;
+        memcpy(out + o, i, literals);
+        i += literals;
+        o += literals;
+        if(i == end)
+            break;
+        if(end - i < 2)
+            return ~0ul;
+        size_t offset = static_cast<uint8>(i[0]) | static_cast<size_t>(static_cast<uint8>(i[1])) << 8;
+        i += 2;
+        if(length == 15 && !get_count(length, i, end))
+            return ~0ul;
+        length += MATCH_MIN;
+        if(!offset || offset > o || max - o < length)
+            return ~0ul;
+        for(const char *m = out + o - offset; length; length--)  // may overlap
+            out[o++] = *m++;
+    }
+    return o;
+}
@@ -0,0 +1,75 @@
+/*
+ * File:   reclaimer.cpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Reclaimer : background eviction and compaction of the Block heap
+ *
+ * Created on 19 octobre 2026
+ */
+
+#include "reclaimer.hpp"
+#include "string.hpp"
+#include "eviction.hpp"
+#include "cold.hpp"
+#include "timer.hpp"
+#include <unistd.h>
+
+Spinlock Reclaimer::lock;
+thread_local unsigned Reclaimer::depth;
+pthread_t Reclaimer::thread;
+unsigned Reclaimer::period;
+bool Reclaimer::active;
+
+/**
+ * Starts the background thread.
+ * @param period_us : polling period of the watermarks
+ * @return false if the thread could not be created
+ */
+bool Reclaimer::start(unsigned period_us) {
+    if(active)
+        return true;
+    period = period_us;
+    active = true;
+    if(pthread_create(&thread, nullptr, run, nullptr)) {
+        active = false;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Stops and joins the background thread. Logging calls are not serialized
+ * anymore once it returns.
+ */
+void Reclaimer::stop() {
+    if(!active)
+        return;
+    __atomic_store_n(&active, false, __ATOMIC_RELEASE);
+    pthread_join(thread, nullptr);
+}
+
+/**
+ * Thread body : the watermarks are read without the lock, as a hint; eviction
+ * itself runs under the lock, so it never interleaves with a logging call. It
+ * is done RECLAIM_SLICE logs at a time, the lock being released in between, so
+ * that a producer never waits for more than a slice, or a defragmentation. The
+ * aging queue logs are then packed into the Cold tier, if it is enabled. The
+ * Timer is calibrated first, off the logging path.
+ */
+void* Reclaimer::run(void*) {
+    Timer::calibrate(); // rather than the first rate limited trace site
+    while(__atomic_load_n(&active, __ATOMIC_ACQUIRE)) {
+        for(bool more = Eviction::above_high(); more;) {
+            depth++; // logging calls made by the eviction must not relock
+            lock.lock();
+            more = Eviction::evict_slice(RECLAIM_SLICE);
+            if(!more)
+                Block::compact();
+            lock.unlock();
+            depth--;
+        }
+        if(Cold::enabled())
+            Cold::migrate();
+        usleep(period);
+    }
+    return nullptr;
+}
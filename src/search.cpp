@@ -0,0 +1,172 @@
+/*
+ * File:   search.cpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Search : SSE2 substring search over the stored logs
+ *
+ * Created on 19 octobre 2026
+ */
+
+#include "search.hpp"
+#include "log_walk.hpp"
+#include "reclaimer.hpp"
+#include "zone.hpp"
+#include <emmintrin.h>
+
+ALWAYS_INLINE
+static inline bool same(const char *s, const char *p, size_t n) {
+    while(n && *s == *p)
+        s++, p++, n--;
+    return !n;
+}
+
+/**
+ * Finds the first occurrence of the pattern p (of length m) in the n bytes of s
+ * @param s
+ * @param n
+ * @param p
+ * @param m
+ * @return the occurrence, or nullptr
+ */
+const char* Search::scan(const char *s, size_t n, const char *p, size_t m) {
+    if(!m || m > n)
+        return nullptr;
+    size_t i = 0, inner = m > 2 ? m - 2 : 0;
+    const __m128i first = _mm_set1_epi8(p[0]), last = _mm_set1_epi8(p[m - 1]);
+    for(; i + m - 1 + 16 <= n; i += 16) {
+        __m128i f = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i)),
+                l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + m - 1));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(first, f), _mm_cmpeq_epi8(last, l))));
+        while(mask) {
+            unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+            if(same(s + i + bit + 1, p + 1, inner))
+                return s + i + bit;
+            mask &= mask - 1;
+        }
+    }
+    for(; i + m <= n; i++)
+        if(s[i] == p[0] && same(s + i + 1, p + 1, m - 1))
+            return s + i;
+    return nullptr;
+}
+
+/**
+ * Looks for any of the patterns in the titles and entries of the logs within
+ * bound. Logs out of bound are skipped without scanning their strings.
+ * @param patterns
+ * @param count : the number of patterns
+ * @param matches : filled with up to max matches, oldest first
+ * @param max
+ * @param bound
+ * @return the total number of matches, which may exceed max
+ */
+size_t Search::find(char const* const* patterns, size_t count, Search_match *matches,
+        size_t max, Search_bound const &bound) {
+    Reclaimer::Guard guard;
+    size_t lengths[count], found = 0;
+    for(size_t k = 0; k < count; k++)
+        lengths[k] = strlen(patterns[k]);
+    auto match = [&](const char *s, size_t n) {
+        for(size_t k = 0; k < count; k++)
+            if(scan(s, n, patterns[k], lengths[k]))
+                return true;
+        return false;
+    };
+    Log_walk::logs([&](Log_view const &l) {
+        if(l.tsc < bound.tsc_from || l.tsc > bound.tsc_to || l.numero < bound.numero_from ||
+                l.numero > bound.numero_to)
+            return;
+        if(match(l.title, l.title_length)) {
+            if(found < max)
+                matches[found] = {l.numero, TITLE, l.tsc, l.store, l.packed != nullptr};
+            found++;
+        }
+        size_t k = 0;
+        Log_walk::entries(l, [&](Entry_view const &e) {
+            if(match(e.text, e.length)) {
+                if(found < max)
+                    matches[found] = {l.numero, k, l.tsc, l.store, l.packed != nullptr};
+                found++;
+            }
+            k++;
+        });
+    });
+    return found;
+}
+
+size_t Search::find(char const *pattern, Search_match *matches, size_t max,
+        Search_bound const &bound) {
+    return find(&pattern, 1, matches, max, bound);
+}
+
+/**
+ * Finds the first occurrence of the phrase p (of length m) in the n bytes of s
+ * which neither starts nor ends in the middle of a token
+ * @param s
+ * @param n
+ * @param p
+ * @param m
+ * @return the occurrence, or nullptr
+ */
+static const char* scan_token(const char *s, size_t n, const char *p, size_t m) {
+    const char *end = s + n, *c = s;
+    while((c = Search::scan(c, static_cast<size_t>(end - c), p, m))) {
+        if((c == s || !Zone::is_token(p[0]) || !Zone::is_token(c[-1])) &&
+                (c + m == end || !Zone::is_token(p[m - 1]) || !Zone::is_token(c[m])))
+            return c;
+        c++;
+    }
+    return nullptr;
+}
+
+/**
+ * Looks for the phrase, as whole tokens, in the titles and entries of the logs
+ * within bound. Store segments whose zone map cannot hold every token of the
+ * phrase, or a log within the tsc bound, are skipped without being read.
+ * @param phrase
+ * @param matches : filled with up to max matches, oldest first
+ * @param max
+ * @param bound
+ * @return the total number of matches, which may exceed max
+ */
+size_t Search::find_token(char const *phrase, Search_match *matches, size_t max,
+        Search_bound const &bound) {
+    Reclaimer::Guard guard;
+    size_t length = strlen(phrase), found = 0;
+    uint64 hashes[16];
+    size_t count = Zone::tokens(phrase, length, hashes, 16);
+    auto visit = [&](Log_view const &l) {
+        if(l.tsc < bound.tsc_from || l.tsc > bound.tsc_to || l.numero < bound.numero_from ||
+                l.numero > bound.numero_to)
+            return;
+        if(scan_token(l.title, l.title_length, phrase, length)) {
+            if(found < max)
+                matches[found] = {l.numero, TITLE, l.tsc, l.store, l.packed != nullptr};
+            found++;
+        }
+        size_t k = 0;
+        Log_walk::entries(l, [&](Entry_view const &e) {
+            if(scan_token(e.text, e.length, phrase, length)) {
+                if(found < max)
+                    matches[found] = {l.numero, k, l.tsc, l.store, l.packed != nullptr};
+                found++;
+            }
+            k++;
+        });
+    };
+    Log_walk::cold_logs(visit);
+    Log_walk::queue_logs(visit);
+    // a store log's number is its index minus the store start
+    size_t start = Log_walk::store_start(), from = start, to = Log_walk::store_cursor();
+    if(bound.numero_from > to - start)
+        return found;
+    from += bound.numero_from;
+    if(bound.numero_to < to - start)
+        to = start + bound.numero_to + 1;
+    for(size_t s = Zone::segment(from); s < to; s += ZONE_LOGS) {
+        if(!Zone::may_match(s, bound.tsc_from, bound.tsc_to, hashes, count))
+            continue;
+        Log_walk::store_logs(s > from ? s : from, s + ZONE_LOGS < to ? s + ZONE_LOGS : to, visit);
+    }
+    return found;
+}
@@ -0,0 +1,135 @@
+/*
+ * File:   sink.cpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Sink : gathered, batched dump output
+ *
+ * Created on 19 octobre 2026
+ */
+
+#include "sink.hpp"
+#include "string.hpp"
+#include <cstdio>
+#include <cerrno>
+#include <unistd.h>
+
+/**
+ * The default sink, the standard output
+ * @return
+ */
+Sink& Sink::out() {
+    static Fd_sink sink(STDOUT_FILENO);
+    return sink;
+}
+
+/**
+ * Gathers size bytes from s, without copying them. Contiguous chunks are merged
+ * in the same iovec.
+ * @param s
+ * @param size
+ */
+void Sink::put(const char* s, size_t size) {
+    if(!size)
+        return;
+    if(iov_count) {
+        iovec &last = iov[iov_count - 1];
+        if(reinterpret_cast<const char*>(last.iov_base) + last.iov_len == s) {
+            last.iov_len += size;
+            return;
+        }
+    }
+    if(iov_count == IOV_NUM)
+        flush();
+    iov[iov_count].iov_base = const_cast<char*>(s);
+    iov[iov_count].iov_len = size;
+    iov_count++;
+}
+
+void Sink::put(const char* s) {
+    put(s, strlen(s));
+}
+
+/**
+ * Formats into the staging buffer; to be used for numbers and short texts only
+ * (FORMAT_MAX bytes at most), stored strings should be put() instead
+ * @param fmt
+ */
+void Sink::format(char const *fmt, ...) {
+    // put() must not flush below : staging would be reused under the new bytes
+    if(STAGING - staging_used < FORMAT_MAX || iov_count == IOV_NUM)
+        flush();
+    va_list args;
+    va_start(args, fmt);
+    unsigned n = String::vprint(staging + staging_used, FORMAT_MAX, fmt, args);
+    va_end(args);
+    put(staging + staging_used, n);
+    staging_used += n;
+}
+
+/**
+ * Hands all gathered bytes over to emit(), and then reuses the staging buffer
+ */
+void Sink::flush() {
+    if(iov_count)
+        emit(iov, iov_count);
+    iov_count = 0;
+    staging_used = 0;
+}
+
+/**
+ * Appends the iovecs to the buffer, doubling it when it is full
+ * @param v
+ * @param count
+ */
+void Buffer_sink::emit(const iovec* v, int count) {
+    for(int i = 0; i < count && !error; i++) {
+        size_t n = v[i].iov_len;
+        if(used + n > capacity) {
+            size_t c = capacity ? capacity : 16 * PAGE_SIZE;
+            while(c < used + n)
+                c *= 2;
+            char *d = reinterpret_cast<char*>(realloc(data, c));
+            if(!d) {
+                error = true;
+                return;
+            }
+            data = d;
+            capacity = c;
+        }
+        memcpy(data + used, v[i].iov_base, n);
+        used += n;
+    }
+}
+
+Buffer_sink::~Buffer_sink() {
+    free(data);
+}
+
+/**
+ * writev the iovecs, resuming after partial writes. Pending stdio output is
+ * flushed first so that it is not interleaved with the dump.
+ * @param v
+ * @param count
+ */
+void Fd_sink::emit(const iovec* v, int count) {
+    fflush(nullptr);
+    iovec *io = const_cast<iovec*>(v);
+    while(count) {
+        ssize_t n = writev(fd, io, count);
+        if(n < 0) {
+            if(errno == EINTR)
+                continue;
+            error = true;
+            return;
+        }
+        size_t written = static_cast<size_t>(n);
+        while(count && written >= io->iov_len) {
+            written -= io->iov_len;
+            io++;
+            count--;
+        }
+        if(count) {
+            io->iov_base = reinterpret_cast<char*>(io->iov_base) + written;
+            io->iov_len -= written;
+        }
+    }
+}
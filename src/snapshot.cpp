@@ -0,0 +1,96 @@
+/*
+ * File:   snapshot.cpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Snapshot : binary serialization of the log stores
+ *
+ * Created on 19 octobre 2026
+ */
+
+#include "snapshot.hpp"
+#include "log_walk.hpp"
+#include "reclaimer.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * Writes a snapshot of all logs to sink, and flushes it
+ * @param sink
+ * @return false if the record tables could not be allocated
+ */
+bool Snapshot::write(Sink &sink) {
+    Reclaimer::Guard guard;
+    size_t logs = 0, entries = 0;
+    Log_walk::logs([&](Log_view const &l) {
+        logs++;
+        entries += l.size;
+    });
+    size_t table = sizeof(Snapshot_header) + logs * sizeof(Snapshot_log) +
+            entries * sizeof(Snapshot_entry);
+    char *buffer = reinterpret_cast<char*>(malloc(table));
+    if(!buffer)
+        return false;
+    Snapshot_header *h = reinterpret_cast<Snapshot_header*>(buffer);
+    Snapshot_log *sl = reinterpret_cast<Snapshot_log*>(h + 1);
+    Snapshot_entry *se = reinterpret_cast<Snapshot_entry*>(sl + logs);
+    uint64 data = table;
+    size_t ei = 0;
+    Log_walk::logs([&](Log_view const &l) {
+        Snapshot_log &r = *sl++;
+        r.numero = l.numero;
+        r.tsc = l.tsc;
+        r.first_entry = ei;
+        r.title = data;
+        r.title_length = static_cast<uint32>(l.title_length);
+        r.entry_count = 0;
+        r.flags = l.store ? SNAPSHOT_STORE : l.packed ? SNAPSHOT_COLD : 0;
+        r.reserved = 0;
+        data += r.title_length;
+        Log_walk::entries(l, [&](Entry_view const &e) {
+            Snapshot_entry &x = se[ei++];
+            x.offset = data;
+            x.length = static_cast<uint32>(e.length);
+            x.tsc_delta = e.tsc_delta;
+            x.reserved = 0;
+            data += x.length;
+            r.entry_count++;
+        });
+    });
+    assert(ei == entries);
+    h->magic = SNAPSHOT_MAGIC;
+    h->version = SNAPSHOT_VERSION;
+    h->header_size = sizeof(Snapshot_header);
+    h->log_count = logs;
+    h->entry_count = entries;
+    h->logs_offset = sizeof(Snapshot_header);
+    h->entries_offset = h->logs_offset + logs * sizeof(Snapshot_log);
+    h->data_offset = table;
+    h->size = data;
+
+    sink.put(buffer, table);
+    Log_walk::logs([&](Log_view const &l) {
+        sink.put(l.title, l.title_length);
+        Log_walk::entries(l, [&](Entry_view const &e) {
+            sink.put(e.text, e.length);
+        });
+    });
+    sink.flush();
+    free(buffer);
+    return true;
+}
+
+/**
+ * Writes a snapshot of all logs to the file path, which is truncated first
+ * @param path
+ * @return false if the file could not be written
+ */
+bool Snapshot::save(char const *path) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0)
+        return false;
+    bool ok;
+    {
+        Fd_sink sink(fd);
+        ok = write(sink) && !sink.failed();
+    }
+    return !close(fd) && ok;
+}
@@ -0,0 +1,208 @@
+/*
+ * File:   spill.cpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Spill : staging ring and background writer of the evicted logs
+ *
+ * Created on 19 octobre 2026
+ */
+
+#include "spill.hpp"
+#include "string.hpp"
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+char *Spill::ring;
+uint64 Spill::size, Spill::head, Spill::tail, Spill::staged;
+size_t Spill::dropped;
+bool Spill::dropping;
+pthread_t Spill::thread;
+bool Spill::running;
+int Spill::fd = -1;
+char Spill::path[256];
+size_t Spill::file_bytes, Spill::files, Spill::written;
+uint64 Spill::sequence;
+
+/**
+ * Starts spilling the evicted logs to path.0, path.1 ... path.(files - 1)
+ * @param p : base path of the spill files
+ * @param bytes : size cap of a file
+ * @param count : number of files rotated through
+ * @param order : the staging ring is 2^order bytes
+ * @return false if the first file, the staging ring or the writer thread could
+ * not be created
+ */
+bool Spill::open(char const *p, size_t bytes, size_t count, unsigned order) {
+    if(ring)
+        return true;
+    if(strlen(p) + 24 > sizeof(path) || !count || bytes <= sizeof(Spill_header))
+        return false;
+    memcpy(path, p, strlen(p) + 1);
+    file_bytes = bytes;
+    files = count;
+    size = 1ull << order;
+    head = tail = staged = sequence = 0;
+    dropping = false;
+    char *r = reinterpret_cast<char*>(malloc(size));
+    if(!r || !rotate()) {
+        free(r);
+        return false;
+    }
+    ring = r;
+    running = true;
+    if(pthread_create(&thread, nullptr, run, nullptr)) {
+        running = false;
+        ring = nullptr;
+        free(r);
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Stages a record, or drops it, and the rest of its log, if the writer thread
+ * is that far behind; it is written out once committed. Called
+ * by the evictions, which are serialized by the Reclaimer lock, so that there
+ * is a single producer at a time.
+ * @param type
+ * @param tsc
+ * @param s : the payload
+ * @param length
+ */
+void Spill::write(uint32 type, uint64 tsc, const char* s, size_t length) {
+    if(dropping)
+        return;
+    uint64 mask = size - 1;
+    if(length > size/4 - sizeof(Journal_record))
+        length = size/4 - sizeof(Journal_record);
+    uint64 need = journal_record_size(static_cast<uint32>(length)), pos = staged & mask,
+            pad = pos + need > size ? size - pos : 0;
+    if(staged + pad + need - __atomic_load_n(&tail, __ATOMIC_ACQUIRE) > size) {
+        dropping = true;
+        return;
+    }
+    if(pad) {
+        Journal_record *p = reinterpret_cast<Journal_record*>(ring + pos);
+        p->length = static_cast<uint32>(pad - sizeof(Journal_record));
+        p->type = JOURNAL_PAD;
+        p->tsc = tsc;
+        pos = 0;
+    }
+    Journal_record *r = reinterpret_cast<Journal_record*>(ring + pos);
+    r->length = static_cast<uint32>(length);
+    r->type = type;
+    r->tsc = tsc;
+    if(length)
+        memcpy(r + 1, s, length);
+    staged += pad + need;
+}
+
+/**
+ * Closes the current file and truncates the next one, which starts with its
+ * Spill_header
+ * @return false if it could not be opened
+ */
+bool Spill::rotate() {
+    if(fd >= 0)
+        ::close(fd);
+    char name[sizeof(path) + 24];
+    snprintf(name, sizeof(name), "%s.%llu", path, sequence % files);
+    fd = ::open(name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0)
+        return false;
+    Spill_header h = {SPILL_MAGIC, JOURNAL_VERSION, sizeof(Spill_header), sequence++};
+    written = sizeof(h);
+    return ::write(fd, &h, sizeof(h)) == sizeof(h);
+}
+
+/**
+ * Appends the staged bytes [from, to) to the current file, a contiguous span of
+ * the ring per write; they are lost on write errors
+ * @param from
+ * @param to
+ */
+void Spill::put(uint64 from, uint64 to) {
+    uint64 mask = size - 1;
+    while(from < to) {
+        uint64 end = min(to, from + size - (from & mask));
+        const char *s = ring + (from & mask);
+        for(uint64 n = end - from; n && fd >= 0;) {
+            ssize_t w = ::write(fd, s, n);
+            if(w <= 0)
+                break;
+            s += w;
+            n -= static_cast<uint64>(w);
+        }
+        written += end - from;
+        from = end;
+    }
+}
+
+/**
+ * Appends every staged record to the files. Records are staged by whole logs,
+ * so the tail always is at the start of a log, and a file is rotated at the
+ * start of the log which would take it over file_bytes, wherever the ring wraps
+ * around : files hold whole logs, but for those bigger than a file, which are
+ * split. Records are lost if no file can be opened.
+ */
+void Spill::drain() {
+    uint64 mask = size - 1, h = __atomic_load_n(&head, __ATOMIC_ACQUIRE), t = tail;
+    while(t < h) {
+        uint64 c = t, log = t;      // c : end of what fits in the file; log : start of the last log
+        while(c < h) {
+            Journal_record *r = reinterpret_cast<Journal_record*>(ring + (c & mask));
+            uint64 rs = journal_record_size(r->length);
+            if(r->type == JOURNAL_LOG)
+                log = c;
+            if(written + (c + rs - t) > file_bytes)
+                break;
+            c += rs;
+        }
+        if(c < h) {
+            if(log > t)
+                c = log;        // the log which does not fit goes to the next file
+            else if(written > sizeof(Spill_header))
+                c = t;          // likewise, but it is the first one
+            else if(c == t)     // a log bigger than a file : at least a record per file
+                c += journal_record_size(reinterpret_cast<Journal_record*>(ring + (t & mask))->length);
+        }
+        put(t, c);
+        if(c < h && !rotate())
+            c = h;              // no file to write to : drop what is staged
+        t = c;
+        __atomic_store_n(&tail, t, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * Thread body : drains the staging ring every SPILL_PERIOD_US, and one last
+ * time once stopped
+ */
+void* Spill::run(void*) {
+    while(__atomic_load_n(&running, __ATOMIC_ACQUIRE)) {
+        drain();
+        usleep(SPILL_PERIOD_US);
+    }
+    drain();
+    return nullptr;
+}
+
+/**
+ * Writes out what is still staged, stops the writer thread and closes the
+ * current file. It must be called once the logging threads are done.
+ */
+void Spill::close() {
+    if(!ring)
+        return;
+    __atomic_store_n(&running, false, __ATOMIC_RELEASE);
+    pthread_join(thread, nullptr);
+    commit();
+    drain();
+    char *r = ring;
+    ring = nullptr;
+    free(r);
+    ::close(fd);
+    fd = -1;
+}
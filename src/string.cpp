@@ -22,14 +22,16 @@
 #include "bits.hpp"
 #include "log.hpp"
 #include "log_store.hpp"
+#include "eviction.hpp"
 #include "panic.hpp"
 
-unsigned String::count;
+thread_local unsigned String::count, String::room = ~0u;
 void* Block::memory;
+void* Block::scratch;
 unsigned short Block::memory_order = 1;
 size_t Block::tour, Block::memory_size = (1ul << memory_order) * PAGE_SIZE, 
         Block::free_memory = Block::memory_size;
-bool Block::reallocated, Block::initialized;
+bool Block::reallocated, Block::initialized, Block::ordered;
 Block* Block::cursor;
 
 Queue<Block> Block::free_blocks, Block::used_blocks;
@@ -46,10 +48,13 @@ String::String(const char *p) : length(strlen(p)){
 int String::vprintf_help(int c, void **ptr) {
     char *dst;
 
+    count++;
+    if(!room)
+        return 0;
+    room--;
     dst = reinterpret_cast<char*> (*ptr);
     *dst++ = static_cast<char> (c);
     *ptr = dst;
-    count++;
     return 0;
 }
 
@@ -204,14 +209,51 @@ void String::vprintf(void *ptr, char const *format, va_list args) {
 unsigned String::print(char *buffer, const char *fmt, ...) {
     va_list args;
     va_start(args, fmt);
-    vprintf(reinterpret_cast<void*> (buffer), fmt, args);
+    unsigned n = vprint(buffer, fmt, args);
+    va_end(args);
+    return n;
+}
+
+/**
+ * Formats into buffer, truncating to size - 1 characters
+ * @return the number of characters written, but the terminating null
+ */
+unsigned String::print(char *buffer, size_t size, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    unsigned n = vprint(buffer, size, fmt, args);
     va_end(args);
+    return n;
+}
+
+unsigned String::vprint(char *buffer, const char *fmt, va_list args) {
+    room = ~0u;
+    vprintf(reinterpret_cast<void*> (buffer), fmt, args);
     *(buffer + count) = '\0';
     unsigned n = count;
     count = 0;
     return n;
 }
 
+/**
+ * Formats into buffer, truncating to size - 1 characters
+ * @param buffer
+ * @param size : of buffer, at least 1
+ * @param fmt
+ * @param args
+ * @return the number of characters written, but the terminating null
+ */
+unsigned String::vprint(char *buffer, size_t size, const char *fmt, va_list args) {
+    assert(size);
+    room = static_cast<unsigned>(min(size - 1, static_cast<size_t>(~0u - 1)));
+    vprintf(reinterpret_cast<void*> (buffer), fmt, args);
+    unsigned n = count < size - 1 ? count : static_cast<unsigned>(size - 1);
+    *(buffer + n) = '\0';
+    count = 0;
+    room = ~0u;
+    return n;
+}
+
 /**
  * this function creates allocates and returns a block of nb_of_bytes octets from 
  * free_blocks circular list. It runs through the free_blocks list and pick the first fit.
@@ -267,28 +309,15 @@ Block* Block::alloc(size_t nb_bytes) {
 }
 
 /**
- * called to delete a certain percentage of log (default 10%), defragment if needed 
- * and try to alloc again
+ * called to evict the oldest logs for nb_bytes to fit, down to the heap low
+ * watermark, defragment if needed and try to alloc again
  */
 Block* Block::realloc(size_t nb_bytes) {
-    // Heap exhausted, free 100% - LOG_PERCENT_TO_BE_LEFT of log to recover fresh memory. 
-    size_t l = left(), s = free_blocks.size();
-    printf("No sufficient memory to allocate to string, Tour %lu required %lu "
-            "free_memory %lu left %lu nbBlocks %lu moyenne %luo\n", tour, nb_bytes, 
-            free_memory, l, s, s ? l/s : 0);
-    assert(l == free_memory);
-    Log::free_logs(LOG_PERCENT_TO_BE_LEFT, true);        
-    Logstore::free_logs(LOG_PERCENT_TO_BE_LEFT, true);   
-    l = left(); s = free_blocks.size(); free_memory = l; 
-    assert(s > 0);// s should > 0
-    printf("After left %lu nbBlocks %lu moyenne %luo\n", l, s, s ? l/s : 0);
-    if(l / s < static_cast<size_t>(STR_MAX_LENGTH*(memory_order + 
-            static_cast<unsigned short>(PAGE_BITS)))){
-        defragment();        
-        print();
-    }
+    // Heap exhausted, evict the oldest logs to recover fresh memory. 
+    assert(left() == free_memory);
+    if(!Eviction::evict_bytes(nb_bytes)) // free memory is too fragmented
+        defragment();
     tour++;
-    cursor = free_blocks.head();
     if(reallocated) {
         die("free_logs() (and may be defragment()) didn't solve space problem");
     }
@@ -297,6 +326,29 @@ Block* Block::realloc(size_t nb_bytes) {
     return alloc(nb_bytes);
 }
 
+/**
+ * Defragments the heap if the average free block is too small. Called by the
+ * Reclaimer thread once it has evicted the oldest logs down to the low watermarks,
+ * which may leave the heap full if the watermarks are above its size
+ * @return true if the heap has been defragmented
+ */
+bool Block::compact() {
+    size_t l = left(), s = free_blocks.size(); 
+    free_memory = l; 
+    if(!s) {    // the heap is full : nothing to compact
+        cursor = nullptr;
+        return false;
+    }
+    bool defragmented = false;
+    if(l / s < static_cast<size_t>(STR_MAX_LENGTH*(memory_order + 
+            static_cast<unsigned short>(PAGE_BITS)))){
+        defragment();        
+        defragmented = true;
+    }
+    cursor = free_blocks.head();
+    return defragmented;
+}
+
 /**
  * called to alloc from the last allocation place called cursor.
  * This is the first allocation attempt
@@ -362,17 +414,13 @@ void Block::free() {
         curr_prev->size += size;
         to_be_deleted = true; // This object exists no more, should be deleted
     } else { // Insert it betwen curr_prev and curr
-        next = curr;
-        prev = curr_prev;
-        curr_prev->next = this;
-        curr->prev = this;
+        free_blocks.insert_before(this, curr);
     }
     /* if previousarea is now contiguous with previousarea->nextchunk, attach them */
     Block *curr_prev_next = curr_prev->next;
     if(curr_prev->start + curr_prev->size == curr_prev_next->start){ // mergeable ?
         curr_prev->size += curr_prev_next->size;
-        curr_prev->next = curr_prev_next->next;
-        curr_prev_next->next->prev = curr_prev;
+        free_blocks.dequeue(curr_prev_next);
         if(curr_prev_next == cursor)
             cursor = curr_prev;
         delete curr_prev_next;
@@ -381,6 +429,20 @@ void Block::free() {
         delete this;
 }
 
+/**
+ * Sizes the heap to 2^order pages, before it is first used
+ * @param order : from 1 to 20
+ * @return false if the heap is already in use
+ */
+bool Block::set_heap_order(unsigned order) {
+    if(initialized)
+        return false;
+    memory_order = static_cast<unsigned short>(min(max(order, 1u), 20u));
+    memory_size = free_memory = (1ul << memory_order) * PAGE_SIZE;
+    ordered = true;
+    return true;
+}
+
 /**
  * For debugging, Just to know the total remaining free size
  * @return 
@@ -398,6 +460,21 @@ size_t Block::left() {
     return total_size;
 }
 
+/**
+ * The size of the largest free block
+ * @return 
+ */
+size_t Block::largest() { 
+    size_t largest = 0;
+    Block *curr = free_blocks.head(), *n = nullptr;
+    while (curr) {
+        largest = max(largest, curr->size);
+        n = curr->next;
+        curr = (n == free_blocks.head()) ? nullptr : n;
+    }
+    return largest;
+}
+
 /**
  * For debugging, Just to know the total remaining free size
  * @return 
@@ -417,16 +494,21 @@ void Block::print() {
     printf("End    ==========================================================\n");    
 }
 
+/**
+ * Moves the used blocks to the start of the heap, through the scratch area, so
+ * that the free memory is left as a single block. Nothing is done if there is
+ * no scratch area
+ */
 void Block::defragment() {
+    if(!scratch)
+        return;
     Block *b = used_blocks.head(), *h = used_blocks.head(), *n = nullptr;
     char* start_ptr1 = reinterpret_cast<char*>(memory);
     size_t total_used_size = 0;
-    char bloc[memory_size - free_memory];
-    char* start_ptr2 = bloc;
-    b = used_blocks.head(); h = used_blocks.head(); n = nullptr;
+    char* start_ptr2 = reinterpret_cast<char*>(scratch);
     while(b) {
         total_used_size += b->size;
-        copy_string(start_ptr2, b->start, b->size);
+        memcpy(start_ptr2, b->start, b->size);
         b->start = start_ptr1;
         start_ptr1 += b->size; 
         start_ptr2 += b->size;
@@ -434,8 +516,10 @@ void Block::defragment() {
         b = (n == h) ? nullptr : n;
     }
     assert(total_used_size == memory_size - free_memory);
-    memset(memory, 0, memory_size);
-    memcpy(memory, reinterpret_cast<void*>(bloc), total_used_size);
+    if(total_used_size)
+        memcpy(memory, scratch, total_used_size);
+    memset(start_ptr1, 0, memory_size - total_used_size);
+    madvise(scratch, total_used_size, MADV_DONTNEED);
     
     while(free_blocks.dequeue(b = free_blocks.head())) {
         delete b;
@@ -0,0 +1,78 @@
+/*
+ * File:   timer.cpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Timer : cheap cycle-accurate timestamps for logs and log entries
+ *
+ * Created on 19 octobre 2026
+ */
+
+#include "timer.hpp"
+#include <ctime>
+#include <cpuid.h>
+
+uint64 Timer::tsc_per_us;
+std::once_flag Timer::calibrated;
+
+/**
+ * Measure how many tsc cycles elapse during 10 ms of CLOCK_MONOTONIC
+ * @return the number of cycles per microsecond
+ */
+uint64 Timer::measure() {
+    timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    uint64 c0 = rdtsc(), ns = 0;
+    do {
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        ns = static_cast<uint64>(t1.tv_sec - t0.tv_sec) * 1000000000ull +
+                t1.tv_nsec - t0.tv_nsec;
+    } while (ns < 10000000ull);
+    uint64 c1 = rdtsc(), r = (c1 - c0) * 1000 / ns;
+    return r ? r : 1;
+}
+
+/**
+ * Sets tsc_per_us up, once : CPUID leaf 0x15 gives the tsc frequency as the
+ * crystal clock frequency times a ratio, when the processor reports both;
+ * the ratio is measured otherwise. Called by the first duration conversion,
+ * unless the Reclaimer thread did it when it started.
+ */
+void Timer::calibrate() {
+    std::call_once(calibrated, [] {
+        unsigned denominator, numerator, crystal_hz, d;
+        uint64 r = 0;
+        if(__get_cpuid(0x15, &denominator, &numerator, &crystal_hz, &d) &&
+                denominator && numerator && crystal_hz)
+            r = static_cast<uint64>(crystal_hz) * numerator / denominator / 1000000;
+        __atomic_store_n(&tsc_per_us, r ? r : measure(), __ATOMIC_RELEASE);
+    });
+}
+
+/**
+ * @return tsc_per_us, set up here by the first conversion
+ */
+uint64 Timer::ratio() {
+    uint64 r = __atomic_load_n(&tsc_per_us, __ATOMIC_ACQUIRE);
+    if(EXPECT_FALSE(!r)) {
+        calibrate();
+        r = __atomic_load_n(&tsc_per_us, __ATOMIC_ACQUIRE);
+    }
+    return r;
+}
+
+/**
+ * Convert a duration in microseconds into tsc cycles
+ * @param us
+ * @return
+ */
+uint64 Timer::us_to_tsc(uint64 us) {
+    return us * ratio();
+}
+
+/**
+ * Convert a duration in tsc cycles into microseconds
+ * @param tsc
+ * @return
+ */
+uint64 Timer::tsc_to_us(uint64 tsc) {
+    return tsc / ratio();
+}
@@ -0,0 +1,96 @@
+/*
+ * File:   trace.cpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Trace : runtime per-level category masks, sampled and rate limited sites
+ *
+ * Created on 19 octobre 2026
+ */
+
+#include "trace.hpp"
+#include "sink.hpp"
+#include <cassert>
+
+Trace_site *Trace_site::sites;
+
+// every category at every compiled level, as before levels existed
+uint32 Trace::mask[LOG_LEVELS] = { Trace::ALL, Trace::ALL, Trace::ALL, Trace::ALL, Trace::ALL };
+
+/**
+ * Logs the category from level on, and not below
+ * @param category
+ * @param level
+ */
+void Trace::enable(unsigned category, unsigned level) {
+    assert(category < LOG_CATEGORIES);
+    set_level(level, 1u << category);
+}
+
+/**
+ * Stops logging the category at all levels
+ * @param category
+ */
+void Trace::disable(unsigned category) {
+    enable(category, LOG_LEVELS);
+}
+
+/**
+ * Logs the categories from level on, and nothing below
+ * @param level
+ * @param categories : mask of the categories affected
+ */
+void Trace::set_level(unsigned level, uint32 categories) {
+    for(unsigned l = 0; l < LOG_LEVELS; l++)
+        if(l >= level)
+            __atomic_or_fetch(&mask[l], categories, __ATOMIC_RELAXED);
+        else
+            __atomic_and_fetch(&mask[l], ~categories, __ATOMIC_RELAXED);
+}
+
+/**
+ * Adds n suppressed events; the site joins the list of reported sites the
+ * first time
+ * @param n
+ */
+void Trace_site::add_suppressed(uint32 n) {
+    __atomic_add_fetch(&suppressed, n, __ATOMIC_RELAXED);
+    if(__atomic_load_n(&registered, __ATOMIC_RELAXED) || __atomic_exchange_n(&registered, true, __ATOMIC_ACQ_REL))
+        return;
+    Trace_site *head = __atomic_load_n(&sites, __ATOMIC_RELAXED);
+    do
+        next = head;
+    while(!__atomic_compare_exchange_n(&sites, &head, this, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+/**
+ * Token bucket (in its GCRA form) : lets per_second events go through per
+ * second, with bursts of up to burst events
+ * @param g
+ * @param per_second
+ * @param burst
+ * @return true if the event goes through
+ */
+bool Trace_site::limit(Gate &g, uint32 per_second, uint32 burst) {
+    uint64 now = Timer::now();
+    if(EXPECT_FALSE(!g.interval)) {
+        g.interval = Timer::us_to_tsc(1000000) / (per_second ? per_second : 1);
+        if(!g.interval)
+            g.interval = 1;
+        g.tat = now;
+    }
+    uint64 tat = g.tat > now ? g.tat : now;
+    if(tat - now > (burst ? burst - 1 : 0) * g.interval)
+        return suppress(g);
+    g.tat = tat + g.interval;
+    return admit(g);
+}
+
+/**
+ * Writes the number of events suppressed by every site which suppressed some.
+ * Up to FOLD - 1 events per thread and site may not be accounted yet.
+ * @param sink
+ */
+void Trace_site::report(Sink &sink) {
+    for(Trace_site *s = __atomic_load_n(&sites, __ATOMIC_ACQUIRE); s; s = s->next)
+        sink.format("Suppressed %llu at %s:%u\n", __atomic_load_n(&s->suppressed, __ATOMIC_RELAXED),
+                s->file, s->line);
+}
@@ -0,0 +1,115 @@
+/*
+ * File:   zone.cpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * The Zone : per-segment zone maps and Bloom filters of the Logstore
+ *
+ * Created on 19 octobre 2026
+ */
+
+#include "zone.hpp"
+#include "util.hpp"
+
+Zone Zone::zones[ZONES];
+size_t Zone::mask = ZONES - 1;
+
+/**
+ * Uses just enough zones for a Logstore of logs logs; called before its first log
+ * @param logs : a power of 2
+ */
+void Zone::resize(size_t logs) {
+    mask = min(max(logs / ZONE_LOGS, 1ul), static_cast<size_t>(ZONES)) - 1;
+}
+
+/**
+ * Calls f(hash) for every token of the n bytes of s (FNV-1a hashes)
+ * @param s
+ * @param n
+ * @param f
+ */
+template <typename F>
+static inline void for_each_token(const char *s, size_t n, F f) {
+    const char *end = s + n;
+    while(s < end) {
+        while(s < end && !Zone::is_token(*s))
+            s++;
+        if(s == end)
+            return;
+        uint64 hash = 0xcbf29ce484222325ull;
+        while(s < end && Zone::is_token(*s))
+            hash = (hash ^ static_cast<uint8>(*s++)) * 0x100000001b3ull;
+        f(hash);
+    }
+}
+
+/**
+ * Hashes the tokens of a query
+ * @param s
+ * @param n
+ * @param hashes : receives up to max token hashes
+ * @param max
+ * @return the number of tokens
+ */
+size_t Zone::tokens(const char *s, size_t n, uint64 *hashes, size_t max) {
+    size_t count = 0;
+    for_each_token(s, n, [&](uint64 hash) {
+        if(count < max)
+            hashes[count++] = hash;
+    });
+    return count;
+}
+
+/**
+ * Records the new log at the absolute index in its segment's summary; the
+ * summary is reset when a segment starts over
+ * @param index
+ * @param tsc
+ * @param title
+ * @param length
+ */
+void Zone::add_log(size_t index, uint64 tsc, const char *title, size_t length) {
+    Zone &z = of(index);
+    if(z.end != segment(index) + ZONE_LOGS) {
+        z.end = segment(index) + ZONE_LOGS;
+        z.tsc_min = tsc;
+        for(unsigned w = 0; w < BLOOM_WORDS; w++)
+            z.bloom[w] = 0;
+    }
+    z.tsc_max = tsc;
+    add_text(index, title, length);
+}
+
+/**
+ * Adds the tokens of a title append or an entry of the log at the absolute index
+ * @param index
+ * @param s
+ * @param n
+ */
+void Zone::add_text(size_t index, const char *s, size_t n) {
+    Zone &z = of(index);
+    if(z.end != segment(index) + ZONE_LOGS)
+        return;
+    for_each_token(s, n, [&](uint64 hash) { z.add(hash); });
+}
+
+/**
+ * May the segment starting at the absolute index first hold a log created
+ * within the tsc bounds and containing all tokens ? A segment without a summary may.
+ * @param first
+ * @param tsc_from
+ * @param tsc_to
+ * @param hashes : the tokens
+ * @param count
+ * @return false if the segment can be skipped
+ */
+bool Zone::may_match(size_t first, uint64 tsc_from, uint64 tsc_to, const uint64 *hashes, 
+        size_t count) {
+    Zone &z = of(first);
+    if(z.end != first + ZONE_LOGS)
+        return true;
+    if(z.tsc_max < tsc_from || z.tsc_min > tsc_to)
+        return false;
+    for(size_t k = 0; k < count; k++)
+        if(!z.has(hashes[k]))
+            return false;
+    return true;
+}
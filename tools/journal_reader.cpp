@@ -0,0 +1,151 @@
+/*
+ * File:   journal_reader.cpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * Post-mortem reader of the journal files written by Journal. The file is
+ * mmapped read-only; every committed record, from tail to head, is rendered
+ * as logs and entries. It may also be run on the journal of a live process.
+ * Spill files (see Spill) are read the same way, from their first record to
+ * the end of the file; a record torn by a crash ends them.
+ *
+ *   journal_reader <file> [info]
+ *
+ * Build : g++ -Iinclude -o journal_reader tools/journal_reader.cpp
+ *
+ * Created on 19 octobre 2026
+ */
+
+#include "journal_format.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+struct Text {
+    const char *s;
+    uint32 length;
+    uint64 tsc;
+};
+
+struct Pending_log {
+    bool started = false;
+    uint64 tsc = 0;
+    Text title = {nullptr, 0, 0};
+    std::vector<Text> appends, entries;
+};
+
+static void die(const char *msg)
+{
+    fprintf(stderr, "%s\n", msg);
+    exit(1);
+}
+
+/**
+ * Prints a log once all its records have been read, since title appends may
+ * follow its entries
+ * @param l
+ * @param numero
+ */
+static void flush(Pending_log &l, uint64 numero) {
+    if(!l.started && l.entries.empty())
+        return;
+    if(l.started)
+        printf("LOG %llu size %zu tsc %llu %.*s", numero, l.entries.size(), l.tsc,
+                static_cast<int>(l.title.length), l.title.s);
+    else
+        printf("LOG ? size %zu (title overwritten)", l.entries.size());
+    for(Text &t : l.appends)
+        printf(" %.*s", static_cast<int>(t.length), t.s);
+    printf("\n");
+    for(Text &t : l.entries)
+        printf("tsc %llu %.*s\n", t.tsc, static_cast<int>(t.length), t.s);
+    l = Pending_log();
+}
+
+int main(int argc, char** argv) {
+    if(argc < 2)
+        die("Usage: journal_reader <file> [info]");
+    int fd = open(argv[1], O_RDONLY);
+    struct stat st;
+    if(fd < 0 || fstat(fd, &st))
+        die("Cannot open journal");
+    size_t size = static_cast<size_t>(st.st_size);
+    if(size < sizeof(Journal_header) && size < sizeof(Spill_header))
+        die("Truncated journal");
+    void *map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if(map == MAP_FAILED)
+        die("Cannot map journal");
+    const Journal_header *h = reinterpret_cast<const Journal_header*>(map);
+    const Spill_header *sh = reinterpret_cast<const Spill_header*>(map);
+    bool spill = sh->magic == SPILL_MAGIC;
+    const char *ring;
+    uint64 ring_size, mask, head, tail;
+    if(spill) {
+        if(sh->version != JOURNAL_VERSION || sh->header_size != sizeof(Spill_header))
+            die("Not a spill file");
+        ring = reinterpret_cast<const char*>(sh + 1);
+        ring_size = size - sizeof(Spill_header);
+        mask = ~0ull;
+        tail = 0;
+        head = ring_size;
+    } else {
+        if(size < sizeof(Journal_header) || h->magic != JOURNAL_MAGIC || h->version != JOURNAL_VERSION)
+            die("Not a journal");
+        ring_size = h->size;
+        mask = ring_size - 1;
+        if(!ring_size || (ring_size & mask) || sizeof(Journal_header) + ring_size > size)
+            die("Corrupted journal");
+        ring = reinterpret_cast<const char*>(h + 1);
+        head = __atomic_load_n(&h->head, __ATOMIC_ACQUIRE);
+        tail = __atomic_load_n(&h->tail, __ATOMIC_ACQUIRE);
+        if(head - tail > ring_size)
+            die("Corrupted journal");
+    }
+
+    if(argc > 2 && !strcmp(argv[2], "info")) {
+        if(spill)
+            printf("version %u spill file %llu bytes %llu\n", sh->version, sh->sequence, ring_size);
+        else
+            printf("version %u ring %llu committed bytes %llu (%llu -> %llu)\n", h->version,
+                    ring_size, head - tail, tail, head);
+        return 0;
+    }
+    Pending_log l;
+    uint64 numero = 0;
+    for(uint64 p = tail; p < head;) {
+        const Journal_record *r = reinterpret_cast<const Journal_record*>(ring + (p & mask));
+        if(spill && p + sizeof(Journal_record) > head)
+            break;
+        uint64 rs = journal_record_size(r->length);
+        if((p & mask) + rs > ring_size) {
+            if(spill)
+                break;
+            die("Corrupted record");
+        }
+        Text t = {reinterpret_cast<const char*>(r + 1), r->length, r->tsc};
+        switch(r->type) {
+            case JOURNAL_LOG:
+                flush(l, numero++);
+                l.started = true;
+                l.tsc = r->tsc;
+                l.title = t;
+                break;
+            case JOURNAL_ENTRY:
+                l.entries.push_back(t);
+                break;
+            case JOURNAL_APPEND:
+                l.appends.push_back(t);
+                break;
+            default:
+                break;
+        }
+        p += rs;
+    }
+    flush(l, numero);
+    munmap(map, size);
+    close(fd);
+    return 0;
+}
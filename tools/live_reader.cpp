@@ -0,0 +1,79 @@
+/*
+ * File:   live_reader.cpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * Live reader of the shared memory ring written by Live : prints the logs,
+ * title appends and entries as they are committed by the producer process,
+ * until it is interrupted. Records which were overwritten before they could be
+ * printed are dropped and reported. The reader only polls, with a short sleep,
+ * once it has caught up with the producer.
+ *
+ *   live_reader </name> [all]     all : from the oldest record kept
+ *
+ * Build : g++ -Iinclude -o live_reader tools/live_reader.cpp -lrt
+ *
+ * Created on 19 octobre 2026
+ */
+
+#include "live_reader.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+
+#define POLL_US     1000
+
+static void die(const char *msg)
+{
+    fprintf(stderr, "%s\n", msg);
+    exit(1);
+}
+
+static void pause_us(long us) {
+    timespec t = {0, us * 1000};
+    nanosleep(&t, nullptr);
+}
+
+int main(int argc, char** argv) {
+    if(argc < 2)
+        die("Usage: live_reader </name> [all]");
+    bool all = argc > 2 && !strcmp(argv[2], "all");
+    Live_reader r;
+    // the producer may not have set the ring up yet
+    for(int k = 0; !r.open(argv[1], all); k++) {
+        if(k == 5000)
+            die("No live ring");
+        pause_us(POLL_US);
+    }
+    Live_record x;
+    // a record is formatted here, and printed only once it is known to be intact
+    static char line[1ul << 16];
+    uint64 numero = 0, lost = 0;
+    while(true) {
+        if(!r.next(x)) {
+            fflush(stdout);
+            pause_us(POLL_US);
+            continue;
+        }
+        int n = 0, length = static_cast<int>(x.length);
+        switch(x.type) {
+            case JOURNAL_LOG:
+                n = snprintf(line, sizeof(line), "LOG %llu tsc %llu %.*s\n", numero, x.tsc, length, x.text);
+                break;
+            case JOURNAL_ENTRY:
+                n = snprintf(line, sizeof(line), "tsc %llu %.*s\n", x.tsc, length, x.text);
+                break;
+            case JOURNAL_APPEND:
+                n = snprintf(line, sizeof(line), "+ %.*s\n", length, x.text);
+                break;
+        }
+        if(!r.valid())
+            continue;
+        if(r.lost() != lost) {
+            printf("... %llu bytes of records lost\n", r.lost() - lost);
+            lost = r.lost();
+        }
+        if(x.type == JOURNAL_LOG)
+            numero++;
+        fwrite(line, 1, n < static_cast<int>(sizeof(line)) ? n : sizeof(line) - 1, stdout);
+    }
+}
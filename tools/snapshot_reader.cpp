@@ -0,0 +1,136 @@
+/*
+ * File:   snapshot_reader.cpp
+ * Author: Parfait Tokponnon <pafait.tokponnon@uclouvain.be>
+ * Offline reader of the log snapshots written by Snapshot::save(). The file is
+ * mmapped and indexed through its record tables : listing only touches the
+ * log table, and only the selected logs' entries are read.
+ *
+ *   snapshot_reader <file> info
+ *   snapshot_reader <file> list [tsc_from tsc_to]
+ *   snapshot_reader <file> show <log index>
+ *   snapshot_reader <file> grep <text>
+ *   snapshot_reader <file> dump
+ *
+ * Build : g++ -Iinclude -o snapshot_reader tools/snapshot_reader.cpp
+ *
+ * Created on 19 octobre 2026
+ */
+
+#include "snapshot_format.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const char *base;
+static const Snapshot_header *header;
+static const Snapshot_log *logs;
+static const Snapshot_entry *entries;
+
+static void die(const char *msg)
+{
+    fprintf(stderr, "%s\n", msg);
+    exit(1);
+}
+
+/**
+ * Checks that the header and every record table fit in the file of size size,
+ * so that the rest of the tool can index them blindly
+ * @param size
+ */
+static void validate(size_t size) {
+    if(size < sizeof(Snapshot_header))
+        die("Truncated snapshot");
+    header = reinterpret_cast<const Snapshot_header*>(base);
+    if(header->magic != SNAPSHOT_MAGIC)
+        die("Not a snapshot");
+    if(header->version != SNAPSHOT_VERSION)
+        die("Unsupported snapshot version");
+    if(header->size > size ||
+            header->logs_offset + header->log_count * sizeof(Snapshot_log) > header->entries_offset ||
+            header->entries_offset + header->entry_count * sizeof(Snapshot_entry) > header->data_offset ||
+            header->data_offset > header->size)
+        die("Corrupted snapshot");
+    logs = reinterpret_cast<const Snapshot_log*>(base + header->logs_offset);
+    entries = reinterpret_cast<const Snapshot_entry*>(base + header->entries_offset);
+}
+
+static bool in_data(uint64 offset, uint32 length) {
+    return offset >= header->data_offset && offset + length <= header->size;
+}
+
+static void print_log(const Snapshot_log &l, bool with_entries) {
+    printf("LOG %llu size %u tsc %llu %s%.*s\n", l.numero, l.entry_count, l.tsc,
+            l.flags & SNAPSHOT_STORE ? "[store] " : l.flags & SNAPSHOT_COLD ? "[cold] " : "",
+            in_data(l.title, l.title_length) ? static_cast<int>(l.title_length) : 0, base + l.title);
+    if(!with_entries || l.first_entry + l.entry_count > header->entry_count)
+        return;
+    for(uint64 k = l.first_entry; k < l.first_entry + l.entry_count; k++) {
+        const Snapshot_entry &e = entries[k];
+        if(in_data(e.offset, e.length))
+            printf("tsc %llu %.*s\n", l.tsc + e.tsc_delta, static_cast<int>(e.length), base + e.offset);
+    }
+}
+
+static bool contains(uint64 offset, uint32 length, const char *text, size_t text_length) {
+    return in_data(offset, length) && memmem(base + offset, length, text, text_length);
+}
+
+int main(int argc, char** argv) {
+    if(argc < 3)
+        die("Usage: snapshot_reader <file> info|list [tsc_from tsc_to]|show <log>|grep <text>|dump");
+    int fd = open(argv[1], O_RDONLY);
+    struct stat st;
+    if(fd < 0 || fstat(fd, &st))
+        die("Cannot open snapshot");
+    size_t size = static_cast<size_t>(st.st_size);
+    void *map = size ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    if(map == MAP_FAILED)
+        die("Cannot map snapshot");
+    base = reinterpret_cast<const char*>(map);
+    validate(size);
+
+    const char *cmd = argv[2];
+    if(!strcmp(cmd, "info")) {
+        printf("version %u logs %llu entries %llu bytes %llu\n", header->version,
+                header->log_count, header->entry_count, header->size);
+    } else if(!strcmp(cmd, "list")) {
+        uint64 from = argc > 4 ? strtoull(argv[3], nullptr, 0) : 0,
+                to = argc > 4 ? strtoull(argv[4], nullptr, 0) : ~0ull;
+        for(uint64 i = 0; i < header->log_count; i++)
+            if(logs[i].tsc >= from && logs[i].tsc <= to) {
+                printf("%llu ", i);
+                print_log(logs[i], false);
+            }
+    } else if(!strcmp(cmd, "show") && argc > 3) {
+        uint64 i = strtoull(argv[3], nullptr, 0);
+        if(i >= header->log_count)
+            die("No such log");
+        print_log(logs[i], true);
+    } else if(!strcmp(cmd, "grep") && argc > 3) {
+        const char *text = argv[3];
+        size_t text_length = strlen(text);
+        for(uint64 i = 0; i < header->log_count; i++) {
+            const Snapshot_log &l = logs[i];
+            bool match = contains(l.title, l.title_length, text, text_length);
+            for(uint64 k = l.first_entry; !match && k < l.first_entry + l.entry_count &&
+                    k < header->entry_count; k++)
+                match = contains(entries[k].offset, entries[k].length, text, text_length);
+            if(match) {
+                printf("%llu ", i);
+                print_log(l, true);
+            }
+        }
+    } else if(!strcmp(cmd, "dump")) {
+        for(uint64 i = 0; i < header->log_count; i++)
+            print_log(logs[i], true);
+    } else {
+        die("Unknown command");
+    }
+    munmap(map, size);
+    close(fd);
+    return 0;
+}